@@ -0,0 +1,231 @@
+// ***************************************************************
+//  xAsyncTableModel   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xAsyncTableModel.h"
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+
+// 一个数据源对应一个上下文；换数据源后旧上下文作废，迟到的结果据此丢弃
+struct xAsyncFetchContext {
+    std::shared_ptr<xAsyncTableProvider> provider;
+    std::atomic_bool cancelled{false};
+    std::atomic_int wanted_block{0};  // 视图最近访问的块
+    std::atomic_int window_blocks{8};  // 离 wanted_block 超过这么远的请求不再真正去取
+};
+
+QVector<QVariantList> xAsyncTableFakeProvider::fetchRows(int first, int count) {
+    if (latency_ms_ > 0) QThread::msleep(latency_ms_);
+    QVector<QVariantList> rows;
+    rows.reserve(count);
+    for (int row = first; row < first + count && row < rows_; ++row) {
+        QVariantList values;
+        values.reserve(columns_);
+        for (int column = 0; column < columns_; ++column) {
+            values.append(qlonglong(row) * columns_ + column);
+        }
+        rows.append(values);
+    }
+    return rows;
+}
+
+xAsyncTableModel::xAsyncTableModel(QObject *parent)
+    : xAbstractTableModel(parent),
+      fetch_pool_(new QThreadPool(this)),
+      shimmer_timer_(new QTimer(this)) {
+    fetch_pool_->setMaxThreadCount(2);
+    blocks_.setMaxCost(64);
+    shimmer_timer_->setInterval(80);
+    connect(shimmer_timer_, &QTimer::timeout, this, &xAsyncTableModel::onShimmerTimer);
+}
+
+xAsyncTableModel::~xAsyncTableModel() {
+    if (context_) context_->cancelled = true;
+    fetch_pool_->waitForDone();
+}
+
+void xAsyncTableModel::setProvider(std::shared_ptr<xAsyncTableProvider> provider) {
+    if (context_) context_->cancelled = true;
+    beginResetModel();
+    provider_ = std::move(provider);
+    context_.reset();
+    blocks_.clear();
+    pending_blocks_.clear();
+    last_block_ = -1;
+    direction_ = 1;
+    rows_ = 0;
+    columns_ = 0;
+    if (provider_) {
+        context_ = std::make_shared<xAsyncFetchContext>();
+        context_->provider = provider_;
+        context_->window_blocks = qMax(8, prefetch_blocks_ * 4);
+        rows_ = qMax(provider_->rowCount(), 0);
+        columns_ = qMax(provider_->columnCount(), 0);
+    }
+    endResetModel();
+    shimmer_timer_->stop();
+}
+
+void xAsyncTableModel::setBlockRows(int rows) {
+    rows = qMax(rows, 1);
+    if (block_rows_ == rows) return;
+    block_rows_ = rows;
+    invalidate();
+}
+
+void xAsyncTableModel::setCacheBlocks(int blocks) {
+    // 至少要装得下一屏加上预取的块，否则刚取回来的块会被马上挤掉
+    blocks_.setMaxCost(qMax(blocks, prefetch_blocks_ + 2));
+}
+
+void xAsyncTableModel::setMaxConcurrentFetches(int fetches) {
+    fetch_pool_->setMaxThreadCount(qMax(fetches, 1));
+}
+
+void xAsyncTableModel::invalidate() {
+    blocks_.clear();
+    // 正在取的块按旧的分块方式计算，结果作废；换一个上下文让它们被丢弃
+    if (context_) {
+        context_->cancelled = true;
+        auto context = std::make_shared<xAsyncFetchContext>();
+        context->provider = provider_;
+        context->window_blocks = context_->window_blocks.load();
+        context_ = context;
+    }
+    pending_blocks_.clear();
+    last_block_ = -1;
+    if (rows_ > 0 && columns_ > 0) {
+        emit dataChanged(index(0, 0), index(rows_ - 1, columns_ - 1));
+    }
+}
+
+bool xAsyncTableModel::isRowLoaded(int row) const {
+    return row >= 0 && row < rows_ && blocks_.contains(row / block_rows_);
+}
+
+int xAsyncTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : columns_;
+}
+
+QVariant xAsyncTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && provider_) {
+        const QVariant header = provider_->headerData(section);
+        if (header.isValid()) return header;
+    }
+    return xAbstractTableModel::headerData(section, orientation, role);
+}
+
+int xAsyncTableModel::baseRowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows_;
+}
+
+QVariant xAsyncTableModel::baseData(const QModelIndex &index, int role) const {
+    const bool value = role == Qt::DisplayRole || role == Qt::EditRole;
+    if ((!value && role != xTableView::LoadingRole) || index.row() >= rows_) return {};
+
+    const int block = index.row() / block_rows_;
+    const QVector<QVariantList> *rows = blocks_.object(block);
+    if (!rows) {
+        touchBlock(block);
+        return role == xTableView::LoadingRole ? QVariant(true) : QVariant();
+    }
+    if (role == xTableView::LoadingRole) return false;
+    const int offset = index.row() - block * block_rows_;
+    if (offset >= rows->size()) return {};
+    const QVariantList &values = rows->at(offset);
+    return index.column() < values.size() ? values.at(index.column()) : QVariant();
+}
+
+Qt::ItemFlags xAsyncTableModel::baseFlags(const QModelIndex &index) const {
+    Q_UNUSED(index);
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+bool xAsyncTableModel::baseSetData(const QModelIndex &index, const QVariant &value, int role) {
+    Q_UNUSED(index);
+    Q_UNUSED(value);
+    Q_UNUSED(role);
+    return false;
+}
+
+bool xAsyncTableModel::insertNewBaseRow(int row, const QVariant &value) {
+    Q_UNUSED(row);
+    Q_UNUSED(value);
+    return false;
+}
+
+void xAsyncTableModel::touchBlock(int block) const {
+    if (block != last_block_) {
+        if (last_block_ >= 0) direction_ = block > last_block_ ? 1 : -1;
+        last_block_ = block;
+        if (context_) context_->wanted_block = block;
+    }
+    requestBlock(block);
+    for (int i = 1; i <= prefetch_blocks_; ++i) requestBlock(block + direction_ * i);
+}
+
+void xAsyncTableModel::requestBlock(int block) const {
+    if (!context_ || block < 0 || qint64(block) * block_rows_ >= rows_) return;
+    if (blocks_.contains(block) || pending_blocks_.contains(block)) return;
+    pending_blocks_.insert(block);
+    if (!shimmer_timer_->isActive()) shimmer_timer_->start();
+
+    auto *self = const_cast<xAsyncTableModel *>(this);
+    const auto context = context_;
+    const int first = block * block_rows_;
+    const int count = qMin(block_rows_, rows_ - first);
+    fetch_pool_->start([self, context, block, first, count]() {
+        // 排队期间视图已经滚远的块不再向数据源要，省下一次慢查询
+        const bool skipped =
+            context->cancelled ||
+            qAbs(block - context->wanted_block.load()) > context->window_blocks.load();
+        QVector<QVariantList> rows;
+        if (!skipped) rows = context->provider->fetchRows(first, count);
+        QMetaObject::invokeMethod(
+            self,
+            [self, context, block, rows = std::move(rows), skipped]() {
+                self->onBlockFetched(context, block, rows, skipped);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void xAsyncTableModel::onBlockFetched(const std::shared_ptr<xAsyncFetchContext> &context,
+                                      int block, const QVector<QVariantList> &rows,
+                                      bool skipped) {
+    if (context != context_) return;  // 数据源已更换或缓存已作废
+    pending_blocks_.remove(block);
+    if (pending_blocks_.isEmpty()) shimmer_timer_->stop();
+    const int first = block * block_rows_;
+    const int last = qMin(first + block_rows_, rows_) - 1;
+    if (skipped) {
+        // 跳过的块不入缓存。视图可能已经滚回来、把它画成了加载中，不会再主动取数；
+        // 通知这些单元格重画，还在屏幕上的会再调 data()，从而重新请求
+        if (columns_ > 0) {
+            emit dataChanged(index(first, 0), index(last, columns_ - 1), {xTableView::LoadingRole});
+        }
+        return;
+    }
+
+    blocks_.insert(block, new QVector<QVariantList>(rows));  // 缓存容量按块计
+    if (columns_ > 0) emit dataChanged(index(first, 0), index(last, columns_ - 1));
+    emit blockLoaded(first, last);
+}
+
+void xAsyncTableModel::onShimmerTimer() {
+    // 只刷新还在加载的块，让占位条的亮带动起来
+    if (columns_ == 0) return;
+    for (int block : std::as_const(pending_blocks_)) {
+        const int first = block * block_rows_;
+        const int last = qMin(first + block_rows_, rows_) - 1;
+        emit dataChanged(index(first, 0), index(last, columns_ - 1), {xTableView::LoadingRole});
+    }
+}
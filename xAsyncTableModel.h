@@ -0,0 +1,135 @@
+#pragma once
+// ***************************************************************
+//  xAsyncTableModel   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableView.h"
+#include <QCache>
+#include <QSet>
+#include <QVector>
+#include <memory>
+
+class QThreadPool;
+class QTimer;
+struct xAsyncFetchContext;
+
+// Data source of an xAsyncTableModel. rowCount / columnCount / headerData run on the GUI
+// thread and must be cheap; fetchRows runs on worker threads (possibly several at once) and
+// may block for as long as the database or RPC takes.
+class xAsyncTableProvider {
+  public:
+    virtual ~xAsyncTableProvider() = default;
+
+    virtual int rowCount() const = 0;
+
+    virtual int columnCount() const = 0;
+
+    virtual QVariant headerData(int section) const {
+        Q_UNUSED(section);
+        return {};
+    }
+
+    // rows first .. first + count - 1, one list of column values per row
+    virtual QVector<QVariantList> fetchRows(int first, int count) = 0;
+};
+
+// In-process provider for trying the model out: cell (r, c) holds r * columns + c, and every
+// fetch sleeps latencyMs first.
+class xAsyncTableFakeProvider : public xAsyncTableProvider {
+    int rows_;
+    int columns_;
+    int latency_ms_;
+
+  public:
+    xAsyncTableFakeProvider(int rows, int columns, int latencyMs)
+        : rows_(rows), columns_(columns), latency_ms_(latencyMs) {}
+
+    int rowCount() const override { return rows_; }
+
+    int columnCount() const override { return columns_; }
+
+    QVector<QVariantList> fetchRows(int first, int count) override;
+};
+
+// Read-only model that never blocks in data(): rows are fetched a block at a time from an
+// xAsyncTableProvider on worker threads. Until its block arrives a cell is empty and reports
+// xTableView::LoadingRole = true, which xItemDelegate paints as a loading shimmer.
+// Fetched blocks live in an LRU cache; blocks ahead of the scroll direction are prefetched.
+class xAsyncTableModel : public xAbstractTableModel {
+    Q_OBJECT
+    std::shared_ptr<xAsyncTableProvider> provider_;
+    std::shared_ptr<xAsyncFetchContext> context_;
+    int rows_ = 0;
+    int columns_ = 0;
+    int block_rows_ = 128;
+    int prefetch_blocks_ = 2;
+    mutable QCache<int, QVector<QVariantList>> blocks_;  // block -> rows, LRU
+    mutable QSet<int> pending_blocks_;
+    mutable int last_block_ = -1;
+    mutable int direction_ = 1;  // +1 scrolling down, -1 up
+    QThreadPool *fetch_pool_ = nullptr;
+    QTimer *shimmer_timer_ = nullptr;
+
+  public:
+    explicit xAsyncTableModel(QObject *parent = nullptr);
+
+    ~xAsyncTableModel() override;
+
+    // resets the model; fetches still running for the old provider are discarded
+    void setProvider(std::shared_ptr<xAsyncTableProvider> provider);
+
+    std::shared_ptr<xAsyncTableProvider> provider() const { return provider_; }
+
+    // rows per fetch; resets the cache
+    void setBlockRows(int rows);
+
+    int blockRows() const { return block_rows_; }
+
+    // blocks fetched ahead of the one being looked at, in the scroll direction
+    void setPrefetchBlocks(int blocks) { prefetch_blocks_ = qMax(blocks, 0); }
+
+    void setCacheBlocks(int blocks);
+
+    void setMaxConcurrentFetches(int fetches);
+
+    // drop every cached block; visible rows are fetched again
+    void invalidate();
+
+    bool isRowLoaded(int row) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+  signals:
+    void blockLoaded(int firstRow, int lastRow);
+
+  protected:
+    int baseRowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant baseData(const QModelIndex &index, int role) const override;
+
+    Qt::ItemFlags baseFlags(const QModelIndex &index) const override;
+
+    bool baseSetData(const QModelIndex &index, const QVariant &value, int role) override;
+
+    bool insertNewBaseRow(int row, const QVariant &value) override;
+
+  private:
+    // block is being looked at: remember the scroll direction, fetch it and the ones ahead
+    void touchBlock(int block) const;
+
+    void requestBlock(int block) const;
+
+    void onBlockFetched(const std::shared_ptr<xAsyncFetchContext> &context, int block,
+                        const QVector<QVariantList> &rows, bool skipped);
+
+    void onShimmerTimer();
+};
@@ -0,0 +1,629 @@
+// ***************************************************************
+//  xColumnarTableModel   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xColumnarTableModel.h"
+#include <algorithm>
+
+QVariant xColumnarTableModel::Snapshot::value(int row, int column) const {
+    const ColumnChunk &chunk = chunkOf(row, column);
+    const int i = row % kChunkRows;
+    if (chunk.nulls.testBit(i)) return {};
+    switch (columns_.at(column).type) {
+        case DoubleColumn:
+            return chunk.doubles.at(i);
+        case Int64Column:
+            return chunk.integers.at(i);
+        case BoolColumn:
+            return chunk.bools.testBit(i);
+        case StringColumn:
+            return string(chunk.ids.at(i));
+        case CategoryColumn: {
+            const quint32 code = columns_.at(column).codes.at(row);
+            if (code == xTableCategoryColumn::kNull) return {};
+            return category(column, code);
+        }
+    }
+    return {};
+}
+
+xColumnSpan<double> xColumnarTableModel::Snapshot::doubles(int column, int chunk) const {
+    const SnapshotColumn &c = columns_.at(column);
+    if (c.type != DoubleColumn) return {};
+    const QVector<double> &values = c.chunks.at(chunk)->doubles;
+    return {values.constData(), int(values.size())};
+}
+
+xColumnSpan<qint64> xColumnarTableModel::Snapshot::int64s(int column, int chunk) const {
+    const SnapshotColumn &c = columns_.at(column);
+    if (c.type != Int64Column) return {};
+    const QVector<qint64> &values = c.chunks.at(chunk)->integers;
+    return {values.constData(), int(values.size())};
+}
+
+xColumnSpan<quint32> xColumnarTableModel::Snapshot::ids(int column, int chunk) const {
+    const SnapshotColumn &c = columns_.at(column);
+    if (c.type == CategoryColumn) {
+        const int first = chunk * kChunkRows;
+        return {c.codes.constData() + first, qMin(kChunkRows, rows_ - first)};
+    }
+    if (c.type != StringColumn) return {};
+    const QVector<quint32> &values = c.chunks.at(chunk)->ids;
+    return {values.constData(), int(values.size())};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+xColumnarTableModel::xColumnarTableModel(QObject *parent) : xAbstractTableModel(parent) {
+    strings_.append(QString());
+    string_ids_.insert(QString(), 0);
+    string_refs_.append(0);
+}
+
+xColumnarTableModel::Snapshot xColumnarTableModel::snapshot() const {
+    // 快照直接共享模型的块，不拷任何单元格。块由 shared_ptr 持有，引用计数是原子的；
+    // 模型写入某块时若还有快照持有它，先拷一份再写（writableChunk），快照看到的块从不改变，
+    // 其它线程可以放心只读。类别码和字典是隐式共享的 QVector，写时同样先分离
+    Snapshot snapshot;
+    snapshot.rows_ = rows_;
+    snapshot.version_ = version_;
+    snapshot.columns_.reserve(columns_.size());
+    for (const Column &column : columns_) {
+        SnapshotColumn shared;
+        shared.title = column.title;
+        shared.type = column.type;
+        shared.chunks.reserve(column.chunks.size());
+        for (const auto &chunk : column.chunks) shared.chunks.append(chunk);
+        if (column.type == CategoryColumn) {
+            shared.codes = column.categories.codes();
+            shared.categories = column.categories.categories();
+        }
+        snapshot.columns_.append(std::move(shared));
+    }
+
+    // 字符串池只追加：装满的块永远不变，只有最后一块在增长时重拷
+    const int stringChunks = (strings_.size() + kSnapshotStringChunk - 1) / kSnapshotStringChunk;
+    snapshot_strings_.resize(stringChunks);
+    for (int k = 0; k < stringChunks; ++k) {
+        const int first = k * kSnapshotStringChunk;
+        const int count = qMin(kSnapshotStringChunk, int(strings_.size()) - first);
+        if (snapshot_strings_.at(k) && snapshot_strings_.at(k)->size() == count) continue;
+        snapshot_strings_[k] = std::make_shared<const QVector<QString>>(strings_.mid(first, count));
+    }
+    snapshot.strings_ = snapshot_strings_;
+    return snapshot;
+}
+
+void xColumnarTableModel::dropSnapshotCache() {
+    snapshot_strings_.clear();
+}
+
+std::shared_ptr<xColumnarTableModel::ColumnChunk> xColumnarTableModel::nullChunk(ColumnType type,
+                                                                                int count) {
+    auto chunk = std::make_shared<ColumnChunk>();
+    switch (type) {
+        case DoubleColumn:
+            chunk->doubles.resize(count);
+            break;
+        case Int64Column:
+            chunk->integers.resize(count);
+            break;
+        case BoolColumn:
+            chunk->bools.resize(count);
+            break;
+        case StringColumn:
+            chunk->ids.resize(count);
+            break;
+        case CategoryColumn:
+            break;  // 类别码存在 categories 里，块里只有空值位图
+    }
+    chunk->nulls.resize(count, true);
+    return chunk;
+}
+
+xColumnarTableModel::ColumnChunk &xColumnarTableModel::writableChunk(Column &column, int chunk) {
+    std::shared_ptr<ColumnChunk> &slot = column.chunks[chunk];
+    // 快照只在 GUI 线程上取，计数为 1 时不会有别的持有者冒出来，可以原地改；
+    // 别的线程正在释放的快照可能让这里多拷一次，但不会改到快照看得见的块
+    if (slot.use_count() > 1) slot = std::make_shared<ColumnChunk>(*slot);
+    return *slot;
+}
+
+void xColumnarTableModel::resetChunks(Column &column) const {
+    // 换成新块而不是原地清空：快照还持有的旧块原样留给快照，不必先拷一份
+    for (int k = 0; k < column.chunks.size(); ++k) {
+        column.chunks[k] = nullChunk(column.type, qMin(kChunkRows, rows_ - k * kChunkRows));
+    }
+}
+
+void xColumnarTableModel::spliceChunks(Column &column, int row, int removed, int inserted) {
+    int rows = 0;
+    if (!column.chunks.isEmpty()) {
+        rows = int(column.chunks.size() - 1) * kChunkRows + column.chunks.last()->nulls.size();
+    }
+    if (removed == 0 && row == rows) {
+        // 末尾追加：在最后一块上原地加长，满了再开新块；逐行追加时不必每次重建整块
+        while (inserted > 0) {
+            if (column.chunks.isEmpty() || column.chunks.last()->nulls.size() == kChunkRows) {
+                const int count = qMin(kChunkRows, inserted);
+                column.chunks.append(nullChunk(column.type, count));
+                inserted -= count;
+                continue;
+            }
+            ColumnChunk &last = writableChunk(column, column.chunks.size() - 1);
+            const int size = last.nulls.size();
+            const int count = qMin(kChunkRows - size, inserted);
+            switch (column.type) {
+                case DoubleColumn:
+                    last.doubles.resize(size + count);
+                    break;
+                case Int64Column:
+                    last.integers.resize(size + count);
+                    break;
+                case BoolColumn:
+                    last.bools.resize(size + count);
+                    break;
+                case StringColumn:
+                    last.ids.resize(size + count);
+                    break;
+                case CategoryColumn:
+                    break;
+            }
+            last.nulls.resize(size + count, true);
+            inserted -= count;
+        }
+        return;
+    }
+
+    // 其余情况：row 所在块及其后各块拼成一段，删改后重新切块。前面的块原样保留
+    // （仍与快照共享）
+    const int firstChunk = row / kChunkRows;
+    const int from = firstChunk * kChunkRows;
+    ColumnChunk tail;
+    for (int k = firstChunk; k < column.chunks.size(); ++k) {
+        const ColumnChunk &chunk = *column.chunks.at(k);
+        tail.doubles += chunk.doubles;
+        tail.integers += chunk.integers;
+        tail.ids += chunk.ids;
+        int at = tail.bools.size();
+        tail.bools.resize(at + chunk.bools.size());
+        tail.bools.storeBitmap(at, chunk.bools, chunk.bools.size());
+        at = tail.nulls.size();
+        tail.nulls.resize(at + chunk.nulls.size());
+        tail.nulls.storeBitmap(at, chunk.nulls, chunk.nulls.size());
+    }
+    const int at = row - from;
+    switch (column.type) {
+        case DoubleColumn:
+            tail.doubles.remove(at, removed);
+            tail.doubles.insert(at, inserted, 0.0);
+            break;
+        case Int64Column:
+            tail.integers.remove(at, removed);
+            tail.integers.insert(at, inserted, 0);
+            break;
+        case BoolColumn:
+            tail.bools.remove(at, removed);
+            tail.bools.insert(at, inserted);
+            break;
+        case StringColumn:
+            tail.ids.remove(at, removed);
+            tail.ids.insert(at, inserted, 0);
+            break;
+        case CategoryColumn:
+            break;
+    }
+    tail.nulls.remove(at, removed);
+    tail.nulls.insert(at, inserted, true);
+
+    column.chunks.resize(firstChunk);
+    const int total = from + tail.nulls.size();
+    for (int first = from; first < total; first += kChunkRows) {
+        const int offset = first - from;
+        const int count = qMin(kChunkRows, total - first);
+        auto chunk = std::make_shared<ColumnChunk>();
+        switch (column.type) {
+            case DoubleColumn:
+                chunk->doubles = tail.doubles.mid(offset, count);
+                break;
+            case Int64Column:
+                chunk->integers = tail.integers.mid(offset, count);
+                break;
+            case BoolColumn:
+                chunk->bools = tail.bools.mid(offset, count);
+                break;
+            case StringColumn:
+                chunk->ids = tail.ids.mid(offset, count);
+                break;
+            case CategoryColumn:
+                break;
+        }
+        chunk->nulls = tail.nulls.mid(offset, count);
+        column.chunks.append(std::move(chunk));
+    }
+}
+
+int xColumnarTableModel::addColumn(const QString &title, ColumnType type) {
+    const int column = columns_.size();
+    beginInsertColumns(QModelIndex(), column, column);
+    Column c;
+    c.title = title;
+    c.type = type;
+    c.chunks.resize(chunkCount());
+    resetChunks(c);
+    if (type == CategoryColumn) c.categories.insert(0, rows_);
+    columns_.append(std::move(c));
+    ++version_;
+    endInsertColumns();
+    return column;
+}
+
+void xColumnarTableModel::setColumnEditable(int column, bool editable) {
+    if (column < 0 || column >= columns_.size()) return;
+    columns_[column].editable = editable;
+}
+
+void xColumnarTableModel::clear() {
+    beginResetModel();
+    columns_.clear();
+    rows_ = 0;
+    strings_.resize(1);
+    string_ids_.clear();
+    string_ids_.insert(QString(), 0);
+    string_refs_.resize(1);
+    free_string_ids_.clear();
+    ++version_;
+    dropSnapshotCache();
+    endResetModel();
+}
+
+void xColumnarTableModel::resizeRows(int rows) {
+    rows = qMax(rows, 0);
+    if (rows > rows_) {
+        insertRows(rows_, rows - rows_);
+    } else if (rows < rows_) {
+        removeRows(rows, rows_ - rows);
+    }
+}
+
+int xColumnarTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : columns_.size();
+}
+
+QVariant xColumnarTableModel::headerData(int section, Qt::Orientation orientation,
+                                         int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 &&
+        section < columns_.size()) {
+        return columns_.at(section).title;
+    }
+    return xAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool xColumnarTableModel::insertRows(int row, int count, const QModelIndex &parent) {
+    // 追加模式的占位行不在存储里，新行最多插到它前面
+    if (parent.isValid() || row < 0 || row > rows_ || count <= 0) return false;
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    insertStorage(row, count);
+    endInsertRows();
+    return true;
+}
+
+bool xColumnarTableModel::removeRows(int row, int count, const QModelIndex &parent) {
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > rows_) return false;
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    removeStorage(row, count);
+    endRemoveRows();
+    return true;
+}
+
+QVariant xColumnarTableModel::value(int row, int column) const {
+    return cellValue(columns_.at(column), strings_, row);
+}
+
+bool xColumnarTableModel::setValue(int row, int column, const QVariant &value) {
+    if (row < 0 || row >= rows_ || column < 0 || column >= columns_.size()) return false;
+    if (!storeValue(row, column, value)) return false;
+    const QModelIndex idx = index(row, column);
+    notifyDataChanged(idx, idx, {Qt::DisplayRole, Qt::EditRole});
+    return true;
+}
+
+void xColumnarTableModel::setNull(int row, int column) {
+    setValue(row, column, QVariant());
+}
+
+void xColumnarTableModel::setDoubleColumn(int column, const QVector<double> &values) {
+    if (column < 0 || column >= columns_.size() || columns_.at(column).type != DoubleColumn) {
+        return;
+    }
+    Column &c = columns_[column];
+    resetChunks(c);
+    const int count = qMin<int>(values.size(), rows_);
+    for (int row = 0; row < count; ++row) {
+        ColumnChunk &chunk = *c.chunks.at(row / kChunkRows);
+        chunk.doubles[row % kChunkRows] = values.at(row);
+        chunk.nulls.setBit(row % kChunkRows, false);
+    }
+    emitColumnChanged(column);
+}
+
+void xColumnarTableModel::setInt64Column(int column, const QVector<qint64> &values) {
+    if (column < 0 || column >= columns_.size() || columns_.at(column).type != Int64Column) {
+        return;
+    }
+    Column &c = columns_[column];
+    resetChunks(c);
+    const int count = qMin<int>(values.size(), rows_);
+    for (int row = 0; row < count; ++row) {
+        ColumnChunk &chunk = *c.chunks.at(row / kChunkRows);
+        chunk.integers[row % kChunkRows] = values.at(row);
+        chunk.nulls.setBit(row % kChunkRows, false);
+    }
+    emitColumnChanged(column);
+}
+
+void xColumnarTableModel::setBoolColumn(int column, const QVector<bool> &values) {
+    if (column < 0 || column >= columns_.size() || columns_.at(column).type != BoolColumn) {
+        return;
+    }
+    Column &c = columns_[column];
+    resetChunks(c);
+    const int count = qMin<int>(values.size(), rows_);
+    for (int row = 0; row < count; ++row) {
+        ColumnChunk &chunk = *c.chunks.at(row / kChunkRows);
+        chunk.bools.setBit(row % kChunkRows, values.at(row));
+        chunk.nulls.setBit(row % kChunkRows, false);
+    }
+    emitColumnChanged(column);
+}
+
+void xColumnarTableModel::setStringColumn(int column, const QStringList &values) {
+    if (column < 0 || column >= columns_.size() || columns_.at(column).type != StringColumn) {
+        return;
+    }
+    Column &c = columns_[column];
+    // 先引用新值再放掉旧列，两边都有的字符串不会被释放后又重新加入
+    const QVector<std::shared_ptr<ColumnChunk>> old = c.chunks;
+    resetChunks(c);
+    const int count = qMin<int>(values.size(), rows_);
+    for (int row = 0; row < count; ++row) {
+        ColumnChunk &chunk = *c.chunks.at(row / kChunkRows);
+        const quint32 id = internString(values.at(row));
+        retainString(id);
+        chunk.ids[row % kChunkRows] = id;
+        chunk.nulls.setBit(row % kChunkRows, false);
+    }
+    for (const auto &chunk : old) {
+        for (quint32 id : std::as_const(chunk->ids)) releaseString(id);
+    }
+    emitColumnChanged(column);
+}
+
+void xColumnarTableModel::setCategoryColumn(int column, const QStringList &values) {
+    if (column < 0 || column >= columns_.size() || columns_.at(column).type != CategoryColumn) {
+        return;
+    }
+    Column &c = columns_[column];
+    resetChunks(c);
+    const int count = qMin<int>(values.size(), rows_);
+    // 相邻行常是同一类别，省掉一次字典查找
+    quint32 code = xTableCategoryColumn::kNull;
+    for (int row = 0; row < count; ++row) {
+        if (row == 0 || values.at(row) != values.at(row - 1)) {
+            code = c.categories.intern(values.at(row));
+        }
+        c.categories.setCode(row, code);
+        c.chunks.at(row / kChunkRows)->nulls.setBit(row % kChunkRows, false);
+    }
+    for (int row = count; row < rows_; ++row) {
+        c.categories.setCode(row, xTableCategoryColumn::kNull);
+    }
+    // 整列重写后旧值的类别都不再用到
+    c.categories.compact();
+    c.categories_kept = c.categories.categoryCount();
+    emitColumnChanged(column);
+}
+
+void xColumnarTableModel::compactCategories(int column) {
+    for (int c = 0; c < columns_.size(); ++c) {
+        if ((column >= 0 && c != column) || columns_.at(c).type != CategoryColumn) continue;
+        Column &target = columns_[c];
+        // 只换编号，单元格的值不变，不发 dataChanged；按编号的缓存靠 generation() 发现
+        if (target.categories.compact()) ++version_;
+        target.categories_kept = target.categories.categoryCount();
+    }
+}
+
+xColumnSpan<double> xColumnarTableModel::doubles(int column, int chunk) const {
+    const Column &c = columns_.at(column);
+    if (c.type != DoubleColumn) return {};
+    const QVector<double> &values = c.chunks.at(chunk)->doubles;
+    return {values.constData(), int(values.size())};
+}
+
+xColumnSpan<qint64> xColumnarTableModel::int64s(int column, int chunk) const {
+    const Column &c = columns_.at(column);
+    if (c.type != Int64Column) return {};
+    const QVector<qint64> &values = c.chunks.at(chunk)->integers;
+    return {values.constData(), int(values.size())};
+}
+
+xColumnSpan<quint32> xColumnarTableModel::stringIds(int column, int chunk) const {
+    const Column &c = columns_.at(column);
+    if (c.type != StringColumn) return {};
+    const QVector<quint32> &values = c.chunks.at(chunk)->ids;
+    return {values.constData(), int(values.size())};
+}
+
+const xTableCategoryColumn *xColumnarTableModel::categoryColumn(int column) const {
+    if (column < 0 || column >= columns_.size()) return nullptr;
+    const Column &c = columns_.at(column);
+    return c.type == CategoryColumn ? &c.categories : nullptr;
+}
+
+quint32 xColumnarTableModel::internString(const QString &text) {
+    auto it = string_ids_.constFind(text);
+    if (it != string_ids_.constEnd()) return it.value();
+    quint32 id;
+    if (!free_string_ids_.isEmpty()) {
+        id = free_string_ids_.takeLast();
+        strings_[id] = text;
+        touchSnapshotString(id);
+    } else {
+        id = strings_.size();
+        strings_.append(text);
+        string_refs_.append(0);
+    }
+    string_ids_.insert(text, id);
+    return id;
+}
+
+int xColumnarTableModel::baseRowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows_;
+}
+
+QVariant xColumnarTableModel::baseData(const QModelIndex &index, int role) const {
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return {};
+    if (index.row() >= rows_ || index.column() >= columns_.size()) return {};
+    return value(index.row(), index.column());
+}
+
+Qt::ItemFlags xColumnarTableModel::baseFlags(const QModelIndex &index) const {
+    Qt::ItemFlags flags = Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+    if (index.column() < columns_.size() && columns_.at(index.column()).editable) {
+        flags |= Qt::ItemIsEditable;
+    }
+    return flags;
+}
+
+bool xColumnarTableModel::baseSetData(const QModelIndex &index, const QVariant &value, int role) {
+    if (role != Qt::EditRole) return false;
+    return setValue(index.row(), index.column(), value);
+}
+
+bool xColumnarTableModel::insertNewBaseRow(int row, const QVariant &value) {
+    Q_UNUSED(value);
+    // begin/endInsertRows 由基类负责，这里只扩充存储，新行各列均为空
+    insertStorage(row, 1);
+    return true;
+}
+
+void xColumnarTableModel::insertStorage(int row, int count) {
+    for (Column &c : columns_) {
+        spliceChunks(c, row, 0, count);
+        if (c.type == CategoryColumn) c.categories.insert(row, count);
+    }
+    rows_ += count;
+    ++version_;
+}
+
+void xColumnarTableModel::removeStorage(int row, int count) {
+    for (Column &c : columns_) {
+        if (c.type == StringColumn) {
+            for (int r = row; r < row + count; ++r) {
+                releaseString(c.chunks.at(r / kChunkRows)->ids.at(r % kChunkRows));
+            }
+        }
+        spliceChunks(c, row, count, 0);
+        if (c.type == CategoryColumn) c.categories.remove(row, count);
+    }
+    rows_ -= count;
+    ++version_;
+}
+
+void xColumnarTableModel::releaseString(quint32 id) {
+    if (id == 0 || --string_refs_[id] != 0) return;
+    // 没有单元格再引用它：移出查找表、释放文本，编号留给下一个新字符串
+    string_ids_.remove(strings_.at(id));
+    strings_[id] = QString();
+    free_string_ids_.append(id);
+    touchSnapshotString(id);
+}
+
+void xColumnarTableModel::touchSnapshotString(quint32 id) {
+    // 已取的快照各自持有旧块，不受影响；只让下一个快照重拷这一块
+    const int chunk = int(id / kSnapshotStringChunk);
+    if (chunk < snapshot_strings_.size()) snapshot_strings_[chunk].reset();
+}
+
+bool xColumnarTableModel::storeValue(int row, int column, const QVariant &value) {
+    ++version_;
+    Column &c = columns_[column];
+    ColumnChunk &chunk = writableChunk(c, row / kChunkRows);
+    const int i = row % kChunkRows;
+    if (!value.isValid()) {
+        chunk.nulls.setBit(i);
+        if (c.type == StringColumn) {
+            releaseString(chunk.ids.at(i));
+            chunk.ids[i] = 0;
+        }
+        if (c.type == CategoryColumn) c.categories.setCode(row, xTableCategoryColumn::kNull);
+        return true;
+    }
+    bool ok = true;
+    switch (c.type) {
+        case DoubleColumn: {
+            const double d = value.toDouble(&ok);
+            if (ok) chunk.doubles[i] = d;
+            break;
+        }
+        case Int64Column: {
+            const qint64 n = value.toLongLong(&ok);
+            if (ok) chunk.integers[i] = n;
+            break;
+        }
+        case BoolColumn:
+            chunk.bools.setBit(i, value.toBool());
+            break;
+        case StringColumn: {
+            // 先引用新值再放旧值：写回同一个字符串时不会先被释放
+            const quint32 id = internString(value.toString());
+            retainString(id);
+            releaseString(chunk.ids.at(i));
+            chunk.ids[i] = id;
+            break;
+        }
+        case CategoryColumn:
+            c.categories.setValue(row, value);
+            // 逐格改写会留下不再用到的类别；字典比上次压缩后翻倍时清一次，均摊到每次写入
+            if (c.categories.categoryCount() > 2 * c.categories_kept + 64) {
+                c.categories.compact();
+                c.categories_kept = c.categories.categoryCount();
+            }
+            break;
+    }
+    if (ok) chunk.nulls.setBit(i, false);
+    return ok;
+}
+
+QVariant xColumnarTableModel::cellValue(const Column &column, const QVector<QString> &strings,
+                                        int row) {
+    const ColumnChunk &chunk = *column.chunks.at(row / kChunkRows);
+    const int i = row % kChunkRows;
+    if (chunk.nulls.testBit(i)) return {};
+    switch (column.type) {
+        case DoubleColumn:
+            return chunk.doubles.at(i);
+        case Int64Column:
+            return chunk.integers.at(i);
+        case BoolColumn:
+            return chunk.bools.testBit(i);
+        case StringColumn:
+            return strings.at(chunk.ids.at(i));
+        case CategoryColumn:
+            return column.categories.value(row);
+    }
+    return {};
+}
+
+void xColumnarTableModel::emitColumnChanged(int column) {
+    ++version_;
+    if (rows_ == 0) return;
+    notifyDataChanged(index(0, column), index(rows_ - 1, column), {Qt::DisplayRole, Qt::EditRole});
+}
@@ -0,0 +1,282 @@
+#pragma once
+// ***************************************************************
+//  xColumnarTableModel   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableView.h"
+#include "xTableCache.h"
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+// Read-only view of one typed chunk of a column. Model spans are valid until the model is
+// next written (a write may move the chunk to a fresh copy); spans taken from an
+// xColumnarTableModel::Snapshot stay valid as long as the snapshot.
+template <typename T>
+struct xColumnSpan {
+    const T *data = nullptr;
+    int size = 0;
+
+    const T &operator[](int i) const { return data[i]; }
+
+    const T *begin() const { return data; }
+
+    const T *end() const { return data + size; }
+
+    bool isEmpty() const { return size == 0; }
+};
+
+// Table model that stores every column as typed contiguous chunks of kChunkRows rows plus a
+// null bitmap, instead of a QVariant per cell. Filters, sorts and statistics can read the
+// chunks directly, and snapshots share them with the model until either side writes.
+class xColumnarTableModel : public xAbstractTableModel {
+    Q_OBJECT
+
+  public:
+    // StringColumn shares one string pool across columns; CategoryColumn keeps a dictionary
+    // of its own, for the few distinct values of a side / venue / status column
+    enum ColumnType { DoubleColumn, Int64Column, BoolColumn, StringColumn, CategoryColumn };
+
+    static constexpr int kChunkRows = 64 * 1024;
+    static constexpr int kSnapshotStringChunk = 4096;
+
+  private:
+    // rows [chunk * kChunkRows, ...) of one column; only the members of its type are filled
+    struct ColumnChunk {
+        QVector<double> doubles;   // DoubleColumn
+        QVector<qint64> integers;  // Int64Column
+        QVector<quint32> ids;      // StringColumn: ids into strings_
+        xTableBitmap bools;        // BoolColumn
+        xTableBitmap nulls;        // set = cell has no value
+    };
+
+    struct Column {
+        QString title;
+        ColumnType type = DoubleColumn;
+        bool editable = true;
+        // shared with snapshots; a write copies the chunk first while one still holds it
+        QVector<std::shared_ptr<ColumnChunk>> chunks;
+        xTableCategoryColumn categories;  // CategoryColumn: codes and dictionary
+        int categories_kept = 0;          // CategoryColumn: dictionary size after compaction
+    };
+
+    QVector<Column> columns_;
+    int rows_ = 0;
+    QVector<QString> strings_;  // interned strings, id 0 is the empty string
+    QHash<QString, quint32> string_ids_;
+    QVector<quint32> string_refs_;      // id -> StringColumn cells holding it
+    QVector<quint32> free_string_ids_;  // released ids, reused by internString
+    quint64 version_ = 0;  // bumped on every change to the stored data
+
+    struct SnapshotColumn {
+        QString title;
+        ColumnType type = DoubleColumn;
+        QVector<std::shared_ptr<const ColumnChunk>> chunks;
+        QVector<quint32> codes;       // CategoryColumn: implicitly shared with the model
+        QVector<QString> categories;  // CategoryColumn: code -> text
+    };
+
+    // string pool chunks of the latest snapshot; dropped when an id in them is released or
+    // reused, otherwise only the growing last one is copied again
+    mutable QVector<std::shared_ptr<const QVector<QString>>> snapshot_strings_;
+
+  public:
+    // Immutable view of the table at one version, for statistics, exports and other
+    // background readers. Taking one copies no cell data: it shares the model's chunks, and
+    // the model copies a chunk only when it writes to one a live snapshot still holds.
+    // Handles are cheap to copy and can be read from any thread.
+    class Snapshot {
+        friend class xColumnarTableModel;
+        QVector<SnapshotColumn> columns_;
+        QVector<std::shared_ptr<const QVector<QString>>> strings_;
+        int rows_ = 0;
+        quint64 version_ = 0;
+
+        const ColumnChunk &chunkOf(int row, int column) const {
+            return *columns_.at(column).chunks.at(row / kChunkRows);
+        }
+
+      public:
+        quint64 version() const { return version_; }
+
+        int rowCount() const { return rows_; }
+
+        int columnCount() const { return columns_.size(); }
+
+        ColumnType columnType(int column) const { return columns_.at(column).type; }
+
+        QString title(int column) const { return columns_.at(column).title; }
+
+        bool isNull(int row, int column) const {
+            return chunkOf(row, column).nulls.testBit(row % kChunkRows);
+        }
+
+        QVariant value(int row, int column) const;
+
+        // typed data of rows [chunk * kChunkRows, ...), empty when column is of another type;
+        // null cells hold 0 / false / ""
+        int chunkCount() const { return (rows_ + kChunkRows - 1) / kChunkRows; }
+
+        xColumnSpan<double> doubles(int column, int chunk) const;
+
+        xColumnSpan<qint64> int64s(int column, int chunk) const;
+
+        // string ids of a StringColumn, category codes of a CategoryColumn
+        xColumnSpan<quint32> ids(int column, int chunk) const;
+
+        const xTableBitmap &bools(int column, int chunk) const {
+            return columns_.at(column).chunks.at(chunk)->bools;
+        }
+
+        const xTableBitmap &nulls(int column, int chunk) const {
+            return columns_.at(column).chunks.at(chunk)->nulls;
+        }
+
+        const QString &string(quint32 id) const {
+            return strings_.at(int(id / kSnapshotStringChunk))->at(int(id % kSnapshotStringChunk));
+        }
+
+        // text of a category code of a CategoryColumn
+        const QString &category(int column, quint32 code) const {
+            return columns_.at(column).categories.at(int(code));
+        }
+    };
+
+    explicit xColumnarTableModel(QObject *parent = nullptr);
+
+    Snapshot snapshot() const;
+
+    // free the string pool chunks kept for the next snapshot; it then copies the pool again
+    void dropSnapshotCache();
+
+    // compare with Snapshot::version() to tell whether a snapshot is still current
+    quint64 version() const { return version_; }
+
+    // new column is null in every existing row; returns its index
+    int addColumn(const QString &title, ColumnType type);
+
+    ColumnType columnType(int column) const { return columns_.at(column).type; }
+
+    void setColumnEditable(int column, bool editable);
+
+    // drop every row and column
+    void clear();
+
+    // grow (with null cells) or shrink the table to rows rows
+    void resizeRows(int rows);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    bool isNull(int row, int column) const {
+        return columns_.at(column).chunks.at(row / kChunkRows)->nulls.testBit(row % kChunkRows);
+    }
+
+    // cell as a QVariant of the column's type, invalid when null
+    QVariant value(int row, int column) const;
+
+    // converts value to the column's type; an invalid QVariant stores null
+    bool setValue(int row, int column, const QVariant &value);
+
+    void setNull(int row, int column);
+
+    // replace a whole column in one go (rows beyond values.size() become null), one dataChanged
+    void setDoubleColumn(int column, const QVector<double> &values);
+
+    void setInt64Column(int column, const QVector<qint64> &values);
+
+    void setBoolColumn(int column, const QVector<bool> &values);
+
+    void setStringColumn(int column, const QStringList &values);
+
+    // the dictionary keeps only the categories of values
+    void setCategoryColumn(int column, const QStringList &values);
+
+    // drop the categories no row of column (-1: every CategoryColumn) uses any more; cell
+    // writes do this on their own once the dictionary has doubled since the last pass
+    void compactCategories(int column = -1);
+
+    int chunkCount() const { return (rows_ + kChunkRows - 1) / kChunkRows; }
+
+    // typed spans of rows [chunk * kChunkRows, ...), empty when column is of another type;
+    // null cells hold 0 / false / ""
+    xColumnSpan<double> doubles(int column, int chunk) const;
+
+    xColumnSpan<qint64> int64s(int column, int chunk) const;
+
+    xColumnSpan<quint32> stringIds(int column, int chunk) const;
+
+    const xTableBitmap &bools(int column, int chunk) const {
+        return columns_.at(column).chunks.at(chunk)->bools;
+    }
+
+    const xTableBitmap &nulls(int column, int chunk) const {
+        return columns_.at(column).chunks.at(chunk)->nulls;
+    }
+
+    const QString &string(quint32 id) const { return strings_.at(id); }
+
+    const xTableCategoryColumn *categoryColumn(int column) const override;
+
+    // id of text in the string pool, adding it when new. A string is released once no cell
+    // holds it any more, and its id is then reused
+    quint32 internString(const QString &text);
+
+  protected:
+    int baseRowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant baseData(const QModelIndex &index, int role) const override;
+
+    Qt::ItemFlags baseFlags(const QModelIndex &index) const override;
+
+    bool baseSetData(const QModelIndex &index, const QVariant &value, int role) override;
+
+    bool insertNewBaseRow(int row, const QVariant &value) override;
+
+  private:
+    static QVariant cellValue(const Column &column, const QVector<QString> &strings, int row);
+
+    void insertStorage(int row, int count);
+
+    void removeStorage(int row, int count);
+
+    bool storeValue(int row, int column, const QVariant &value);
+
+    void emitColumnChanged(int column);
+
+    void retainString(quint32 id) {
+        if (id != 0) ++string_refs_[id];
+    }
+
+    void releaseString(quint32 id);
+
+    // the snapshot copy of the pool chunk holding id is stale
+    void touchSnapshotString(quint32 id);
+
+    // new chunk of count null rows
+    static std::shared_ptr<ColumnChunk> nullChunk(ColumnType type, int count);
+
+    // chunk of column, copied first when a snapshot still holds it
+    static ColumnChunk &writableChunk(Column &column, int chunk);
+
+    // replace every chunk of column by a new null one, for setters rewriting the column
+    void resetChunks(Column &column) const;
+
+    // remove removed rows at row, then insert inserted null rows there; chunks from the one
+    // holding row on are rebuilt
+    static void spliceChunks(Column &column, int row, int removed, int inserted);
+};
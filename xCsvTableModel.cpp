@@ -0,0 +1,255 @@
+// ***************************************************************
+//  xCsvTableModel   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xCsvTableModel.h"
+#include <QFileInfo>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+// 每隔这么多条记录存一个文件偏移；取某一行时从所在块的起点往后解析
+static constexpr int kBlockRows = 32;
+// 后台索引每找到这么多行向 GUI 线程报告一次，新行随之出现在视图里
+static constexpr int kIndexPostRows = 64 * 1024;
+
+struct xCsvIndexJob {
+    std::atomic_bool cancelled{false};
+};
+
+// 单元格的类型：整数、浮点，其余按 UTF-8 文本；前导 0 的数字串（编号之类）保留为文本
+static QVariant toCell(const QByteArray &field) {
+    if (field.isEmpty()) return {};
+    const bool leadingZero = field.size() > 1 && field.at(0) == '0' && field.at(1) != '.';
+    if (!leadingZero) {
+        bool ok = false;
+        const qlonglong i = field.toLongLong(&ok);
+        if (ok) return i;
+        const double d = field.toDouble(&ok);
+        if (ok) return d;
+    }
+    return QString::fromUtf8(field);
+}
+
+xCsvTableModel::xCsvTableModel(QObject *parent)
+    : xAbstractTableModel(parent), index_pool_(new QThreadPool(this)) {
+    index_pool_->setMaxThreadCount(1);
+    blocks_.setMaxCost(2048);
+}
+
+xCsvTableModel::~xCsvTableModel() {
+    // 工作线程直接读映射内存，必须在文件关闭前退出
+    if (index_job_) index_job_->cancelled = true;
+    index_pool_->waitForDone();
+}
+
+bool xCsvTableModel::open(const QString &path, char delimiter, bool hasHeader) {
+    close();
+
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) return false;
+    size_ = file_.size();
+    if (size_ > 0) {
+        data_ = reinterpret_cast<const char *>(file_.map(0, size_));
+        if (!data_) {
+            file_.close();
+            size_ = 0;
+            return false;
+        }
+    }
+    if (delimiter == 0) {
+        const QString suffix = QFileInfo(path).suffix().toLower();
+        delimiter = suffix == "tsv" || suffix == "tab" ? '\t' : ',';
+    }
+    delimiter_ = delimiter;
+
+    qint64 start = 0;
+    if (size_ >= 3 && std::memcmp(data_, "\xEF\xBB\xBF", 3) == 0) start = 3;
+    beginResetModel();
+    if (start < size_) {
+        QVariantList fields;
+        const qint64 next = parseRecord(start, &fields);
+        columns_ = fields.size();
+        if (hasHeader) {
+            for (const QVariant &field : std::as_const(fields)) headers_ << field.toString();
+            start = next;
+        }
+    }
+    endResetModel();
+
+    // 后台只找记录边界（跳过引号内的换行），不解析字段
+    auto job = std::make_shared<xCsvIndexJob>();
+    index_job_ = job;
+    index_pool_->start([this, job, data = data_, size = size_, start]() {
+        QVector<qint64> offsets;
+        int rows = 0;
+        bool quoted = false;
+        qint64 record = start;
+        qint64 pos = start;
+        const auto post = [&](bool finished) {
+            QMetaObject::invokeMethod(
+                this,
+                [this, job, offsets, rows, bytes = qMin(pos, size), finished]() {
+                    onIndexChunk(job, offsets, rows, bytes, finished);
+                },
+                Qt::QueuedConnection);
+            offsets.clear();
+        };
+        while (pos < size) {
+            if (job->cancelled.load(std::memory_order_relaxed)) return;
+            const char *newline =
+                static_cast<const char *>(std::memchr(data + pos, '\n', size - pos));
+            const qint64 end = newline ? newline - data : size;
+            if (std::count(data + pos, data + end, '"') & 1) quoted = !quoted;
+            pos = end + 1;
+            if (quoted && newline) continue;  // 引号内的换行属于同一条记录
+            if (rows % kBlockRows == 0) offsets.append(record);
+            ++rows;
+            record = pos;
+            if (rows % kIndexPostRows == 0) post(false);
+        }
+        post(true);
+    });
+    return true;
+}
+
+void xCsvTableModel::close() {
+    if (index_job_) {
+        index_job_->cancelled = true;
+        index_job_.reset();
+    }
+    index_pool_->waitForDone();
+
+    beginResetModel();
+    blocks_.clear();
+    block_offsets_.clear();
+    headers_.clear();
+    rows_ = 0;
+    columns_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+    file_.close();  // 同时解除映射
+    endResetModel();
+}
+
+void xCsvTableModel::setCacheRows(int rows) {
+    blocks_.setMaxCost(qMax(rows, kBlockRows));
+}
+
+int xCsvTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : columns_;
+}
+
+QVariant xCsvTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 &&
+        section < headers_.size()) {
+        return headers_.at(section);
+    }
+    return xAbstractTableModel::headerData(section, orientation, role);
+}
+
+int xCsvTableModel::baseRowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows_;
+}
+
+QVariant xCsvTableModel::baseData(const QModelIndex &index, int role) const {
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return {};
+    if (index.row() >= rows_) return {};
+    const QVector<QVariantList> *rows = block(index.row() / kBlockRows);
+    const int offset = index.row() % kBlockRows;
+    if (!rows || offset >= rows->size()) return {};
+    const QVariantList &fields = rows->at(offset);
+    return index.column() < fields.size() ? fields.at(index.column()) : QVariant();
+}
+
+Qt::ItemFlags xCsvTableModel::baseFlags(const QModelIndex &index) const {
+    Q_UNUSED(index);
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+bool xCsvTableModel::baseSetData(const QModelIndex &index, const QVariant &value, int role) {
+    Q_UNUSED(index);
+    Q_UNUSED(value);
+    Q_UNUSED(role);
+    return false;
+}
+
+bool xCsvTableModel::insertNewBaseRow(int row, const QVariant &value) {
+    Q_UNUSED(row);
+    Q_UNUSED(value);
+    return false;
+}
+
+void xCsvTableModel::onIndexChunk(const std::shared_ptr<xCsvIndexJob> &job,
+                                  const QVector<qint64> &offsets, int rows, qint64 bytesIndexed,
+                                  bool finished) {
+    if (job != index_job_) return;  // 已被 close / 重新 open 取消
+    block_offsets_ += offsets;
+    if (rows > rows_) {
+        beginInsertRows(QModelIndex(), rows_, rows - 1);
+        rows_ = rows;
+        endInsertRows();
+    }
+    emit indexProgress(bytesIndexed, size_);
+    if (finished) {
+        index_job_.reset();
+        emit indexFinished();
+    }
+}
+
+const QVector<QVariantList> *xCsvTableModel::block(int index) const {
+    if (index < 0 || index >= block_offsets_.size()) return nullptr;
+    if (const QVector<QVariantList> *rows = blocks_.object(index)) return rows;
+
+    // 块内的记录一次解析完：视图总是成片地取相邻行
+    auto *rows = new QVector<QVariantList>;
+    rows->reserve(kBlockRows);
+    qint64 pos = block_offsets_.at(index);
+    for (int i = 0; i < kBlockRows && pos < size_; ++i) {
+        QVariantList fields;
+        fields.reserve(columns_);
+        pos = parseRecord(pos, &fields);
+        rows->append(fields);
+    }
+    const int cost = qMax<int>(rows->size(), 1);
+    if (!blocks_.insert(index, rows, cost)) return nullptr;
+    return rows;
+}
+
+qint64 xCsvTableModel::parseRecord(qint64 pos, QVariantList *fields) const {
+    QByteArray field;
+    bool quoted = false;
+    while (pos < size_) {
+        const char c = data_[pos++];
+        if (quoted) {
+            if (c != '"') {
+                field += c;
+            } else if (pos < size_ && data_[pos] == '"') {
+                field += '"';  // "" 转义
+                ++pos;
+            } else {
+                quoted = false;
+            }
+            continue;
+        }
+        if (c == '"') {
+            quoted = true;
+        } else if (c == delimiter_) {
+            fields->append(toCell(field));
+            field.clear();
+        } else if (c == '\n') {
+            break;
+        } else if (c != '\r') {
+            field += c;
+        }
+    }
+    fields->append(toCell(field));
+    return pos;
+}
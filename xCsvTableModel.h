@@ -0,0 +1,84 @@
+#pragma once
+// ***************************************************************
+//  xCsvTableModel   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableView.h"
+#include <QCache>
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+class QThreadPool;
+struct xCsvIndexJob;
+
+// Read-only model over a memory-mapped CSV / TSV file. open() returns as soon as the header
+// is read; a worker thread then indexes record offsets and rows appear as they are found.
+// Cells are parsed only for rows that are asked for, a block of rows at a time, and kept in
+// a small LRU, so memory follows the viewport rather than the file size.
+class xCsvTableModel : public xAbstractTableModel {
+    Q_OBJECT
+    QFile file_;
+    const char *data_ = nullptr;
+    qint64 size_ = 0;
+    char delimiter_ = ',';
+    QStringList headers_;
+    int columns_ = 0;
+    int rows_ = 0;
+    QVector<qint64> block_offsets_;  // file offset of every kBlockRows-th record
+    mutable QCache<int, QVector<QVariantList>> blocks_;  // block -> parsed rows, LRU
+    QThreadPool *index_pool_ = nullptr;
+    std::shared_ptr<xCsvIndexJob> index_job_;
+
+  public:
+    explicit xCsvTableModel(QObject *parent = nullptr);
+
+    ~xCsvTableModel() override;
+
+    // delimiter 0 picks '\t' for .tsv / .tab files and ',' otherwise
+    bool open(const QString &path, char delimiter = 0, bool hasHeader = true);
+
+    void close();
+
+    bool isIndexing() const { return index_job_ != nullptr; }
+
+    // number of parsed rows kept in memory (rounded to whole blocks)
+    void setCacheRows(int rows);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+  signals:
+    void indexProgress(qint64 bytesIndexed, qint64 totalBytes);
+
+    void indexFinished();
+
+  protected:
+    int baseRowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant baseData(const QModelIndex &index, int role) const override;
+
+    Qt::ItemFlags baseFlags(const QModelIndex &index) const override;
+
+    bool baseSetData(const QModelIndex &index, const QVariant &value, int role) override;
+
+    bool insertNewBaseRow(int row, const QVariant &value) override;
+
+  private:
+    void onIndexChunk(const std::shared_ptr<xCsvIndexJob> &job, const QVector<qint64> &offsets,
+                      int rows, qint64 bytesIndexed, bool finished);
+
+    const QVector<QVariantList> *block(int index) const;
+
+    // parse one record starting at pos, returning the offset just past it
+    qint64 parseRecord(qint64 pos, QVariantList *fields) const;
+};
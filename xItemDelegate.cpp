@@ -21,6 +21,8 @@
 #include <QLayout>
 #include <QLineEdit>
 #include <QPainter>
+#include <QDateTime>
+#include <QLinearGradient>
 #include <QCheckBox>
 #include <QMouseEvent>
 #include <QPersistentModelIndex>
@@ -514,6 +516,10 @@ void xItemDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
                           const QModelIndex &idx) const {
     QStyleOptionViewItem option = opt;
     initStyleOption(&option, idx);
+    if (idx.data(xTableView::LoadingRole).toBool()) {
+        paintLoading(p, option);
+        return;
+    }
     QVariant data = idx.data(Qt::EditRole);
 
     // Handle bool type specially
@@ -573,9 +579,46 @@ void xItemDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
         if (cond.toString() == "error") option.palette.setColor(QPalette::Text, Qt::red);
     }
 
+    // 查找“全部高亮”：命中且未选中的单元格换成醒目的底色
+    auto view = qobject_cast<const xTableView *>(option.widget);
+    if (view && !(option.state & QStyle::State_Selected) && view->isSearchHighlighted(idx)) {
+        option.backgroundBrush = QColor(255, 230, 120);
+    }
+
     QStyledItemDelegate::paint(p, option, idx);
 }
 
+void xItemDelegate::paintLoading(QPainter *p, const QStyleOptionViewItem &option) const {
+    if (option.state & QStyle::State_Selected) {
+        p->fillRect(option.rect, option.palette.highlight());
+    } else if (option.backgroundBrush.style() != Qt::NoBrush) {
+        p->fillRect(option.rect, option.backgroundBrush);
+    }
+    const int margin = qMax(2, option.rect.height() / 3);
+    const QRect bar = option.rect.adjusted(4, margin, -4, -margin);
+    if (bar.width() <= 0 || bar.height() <= 0) return;
+
+    // 高光位置由时间决定，模型在加载期间定时刷新这些格子，亮带就会扫过去
+    const qreal phase = (QDateTime::currentMSecsSinceEpoch() % 1200) / 1200.0;
+    QColor base = option.palette.color(QPalette::Mid);
+    base.setAlpha(60);
+    QColor shine = option.palette.color(QPalette::Midlight);
+    shine.setAlpha(160);
+    QLinearGradient gradient(bar.topLeft(), bar.topRight());
+    gradient.setColorAt(0.0, base);
+    gradient.setColorAt(qBound(0.01, phase - 0.2, 0.97), base);
+    gradient.setColorAt(qBound(0.02, phase, 0.98), shine);
+    gradient.setColorAt(qBound(0.03, phase + 0.2, 0.99), base);
+    gradient.setColorAt(1.0, base);
+
+    p->save();
+    p->setRenderHint(QPainter::Antialiasing);
+    p->setPen(Qt::NoPen);
+    p->setBrush(gradient);
+    p->drawRoundedRect(bar, 3, 3);
+    p->restore();
+}
+
 bool xItemDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
                                 const QStyleOptionViewItem &option, const QModelIndex &index) {
     // 确保是布尔类型的列
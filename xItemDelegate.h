@@ -54,6 +54,10 @@ class xItemDelegate : public QStyledItemDelegate {
     // 单元格编辑器上的粘贴处理（编辑器由 view 自动安装本代理为事件过滤器）
     bool eventFilter(QObject *object, QEvent *event) override;
 
+  private:
+    // placeholder bar with a moving highlight for cells whose LoadingRole is true
+    void paintLoading(QPainter *p, const QStyleOptionViewItem &option) const;
+
   private slots:
 
     void commitAndCloseEditor();
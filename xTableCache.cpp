@@ -0,0 +1,935 @@
+// ***************************************************************
+//  xTableCache   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableCache.h"
+#include "xTableView.h"
+#include <QAbstractItemModel>
+#include <QtAlgorithms>
+#include <zce/zce_any.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+xTableCellValue xTableCellValue::decode(const QVariant &data) {
+    xTableCellValue value;
+    value.text = data.toString();
+    switch (data.typeId()) {
+        case QMetaType::UnknownType:
+            value.kind = Null;
+            break;
+        case QMetaType::Bool:
+            value.kind = Bool;
+            value.integer = data.toBool() ? 1 : 0;
+            value.number = static_cast<double>(value.integer);
+            break;
+        case QMetaType::Int:
+            value.kind = Int;
+            value.integer = data.toInt();
+            value.number = static_cast<double>(value.integer);
+            break;
+        case QMetaType::UInt:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Char:
+        case QMetaType::SChar:
+        case QMetaType::UChar:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+            value.kind = LongLong;
+            value.integer = data.toLongLong();
+            value.number = static_cast<double>(value.integer);
+            break;
+        case QMetaType::Float:
+            value.kind = Float;
+            value.number = data.toDouble();
+            break;
+        case QMetaType::Double:
+            value.kind = Double;
+            value.number = data.toDouble();
+            break;
+        case QMetaType::QString:
+            value.kind = String;
+            break;
+        default:
+            value.kind = Other;
+            value.other = data;
+            if (!rangeNumber(data, value.number)) {
+                value.number = std::numeric_limits<double>::quiet_NaN();
+            }
+            break;
+    }
+    return value;
+}
+
+bool xTableCellValue::rangeNumber(const QVariant &data, double &number) {
+    switch (data.typeId()) {
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Char:
+        case QMetaType::SChar:
+        case QMetaType::UChar:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Float:
+        case QMetaType::Double:
+            number = data.toDouble();
+            return true;
+        default:
+            break;
+    }
+    if (data.userType() == qMetaTypeId<zce::Any>()) {
+        const zce::Any a = data.value<zce::Any>();
+        if (a.is_double()) {
+            number = a.dbl();
+            return true;
+        }
+        if (a.is_i64()) {
+            number = static_cast<double>(a.i64());
+            return true;
+        }
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+xTableBitmap::xTableBitmap(int size, bool value) {
+    resize(size, value);
+}
+
+void xTableBitmap::fill(bool value) {
+    words_.fill(value ? ~quint64(0) : quint64(0));
+    clearTail();
+}
+
+void xTableBitmap::resize(int size, bool value) {
+    size = qMax(size, 0);
+    const int oldSize = size_;
+    words_.resize((size + 63) >> 6);
+    size_ = size;
+    if (size > oldSize) {
+        // resize 出来的新字已经是 0，只需处理旧尾字里多出的那几位
+        for (int i = oldSize; i < size && (i & 63); ++i) setBit(i, value);
+        if (value) {
+            for (int w = (oldSize + 63) >> 6; w < words_.size(); ++w) words_[w] = ~quint64(0);
+        }
+    }
+    clearTail();
+}
+
+void xTableBitmap::insert(int pos, int count, bool value) {
+    if (count <= 0) return;
+    pos = qBound(0, pos, size_);
+    // 按整字搬移：先取出 pos 之后的位，填好新位，再整体写回到后面
+    const xTableBitmap tail = mid(pos, size_ - pos);
+    resize(size_ + count);
+    const quint64 fill = value ? ~quint64(0) : quint64(0);
+    for (int i = 0; i < count; i += 64) storeBits(pos + i, fill, qMin(64, count - i));
+    storeBitmap(pos + count, tail, tail.size());
+}
+
+void xTableBitmap::remove(int pos, int count) {
+    if (pos < 0 || pos >= size_ || count <= 0) return;
+    count = qMin(count, size_ - pos);
+    const xTableBitmap tail = mid(pos + count, size_ - pos - count);
+    storeBitmap(pos, tail, tail.size());
+    resize(size_ - count);
+}
+
+xTableBitmap xTableBitmap::mid(int pos, int count) const {
+    pos = qBound(0, pos, size_);
+    count = qBound(0, count, size_ - pos);
+    xTableBitmap result(count);
+    for (int w = 0; w < result.words_.size(); ++w) result.words_[w] = wordAt(pos + (w << 6));
+    result.clearTail();
+    return result;
+}
+
+int xTableBitmap::count() const {
+    int total = 0;
+    for (quint64 word : words_) total += qPopulationCount(word);
+    return total;
+}
+
+xTableBitmap &xTableBitmap::operator&=(const xTableBitmap &other) {
+    const int words = qMin(words_.size(), other.words_.size());
+    quint64 *dst = words_.data();
+    const quint64 *src = other.words_.constData();
+    for (int w = 0; w < words; ++w) dst[w] &= src[w];
+    return *this;
+}
+
+quint64 xTableBitmap::wordAt(int pos) const {
+    if (pos >= size_) return 0;
+    const int word = pos >> 6;
+    const int shift = pos & 63;
+    quint64 bits = words_.at(word) >> shift;
+    // 跨字时拼上下一个字的低位；尾字多出的位已由 clearTail 清零
+    if (shift && word + 1 < words_.size()) bits |= words_.at(word + 1) << (64 - shift);
+    return bits;
+}
+
+void xTableBitmap::storeBits(int pos, quint64 bits, int n) {
+    const quint64 mask = n >= 64 ? ~quint64(0) : (quint64(1) << n) - 1;
+    bits &= mask;
+    const int word = pos >> 6;
+    const int shift = pos & 63;
+    words_[word] = (words_[word] & ~(mask << shift)) | (bits << shift);
+    if (shift && shift + n > 64) {
+        // 跨到下一个字的部分
+        const int low = 64 - shift;
+        words_[word + 1] = (words_[word + 1] & ~(mask >> low)) | (bits >> low);
+    }
+}
+
+void xTableBitmap::storeBitmap(int pos, const xTableBitmap &src, int n) {
+    for (int i = 0; i < n; i += 64) storeBits(pos + i, src.wordAt(i), qMin(64, n - i));
+}
+
+void xTableBitmap::clearTail() {
+    // 尾字中超出 size_ 的位保持为 0，count() 和按字运算才不会数进去
+    if (size_ & 63) words_.last() &= (quint64(1) << (size_ & 63)) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool xTableColumnCache::equals(int row, const xTableCellValue &value) const {
+    const xTableCellValue::Kind cell = kind(row);
+    // 与 Qt6 的 QVariant::operator== 保持一致：数值类型之间按数值比较（都为整数时按整数比较），
+    // 其余类型只有类型相同才可能相等，不做字符串与数字之间的转换。
+    if (xTableCellValue::isNumber(cell) && value.isNumber()) {
+        if (xTableCellValue::isIntegral(cell) && value.isIntegral()) {
+            return integers_.at(row) == value.integer;
+        }
+        return numbers_.at(row) == value.number;
+    }
+    if (cell != value.kind) return false;
+    switch (cell) {
+        case xTableCellValue::Null:
+            return true;
+        case xTableCellValue::String:
+            return texts_.at(row) == value.text;
+        case xTableCellValue::Other:
+            return others_.at(row) == value.other;
+        default:
+            return false;
+    }
+}
+
+void xTableColumnCache::clear() {
+    kinds_.clear();
+    numbers_.clear();
+    integers_.clear();
+    texts_.clear();
+    others_.clear();
+}
+
+void xTableColumnCache::fill(const QAbstractItemModel *model, int column, int role) {
+    clear();
+    if (!model) return;
+    insertRows(model, column, role, 0, model->rowCount() - 1);
+}
+
+void xTableColumnCache::update(const QAbstractItemModel *model, int column, int role, int first,
+                               int last) {
+    if (!model) return;
+    first = qMax(first, 0);
+    last = qMin(last, rowCount() - 1);
+    for (int row = first; row <= last; ++row) {
+        store(row, model->data(model->index(row, column), role));
+    }
+}
+
+void xTableColumnCache::insertRows(const QAbstractItemModel *model, int column, int role,
+                                   int first, int last) {
+    if (!model || last < first) return;
+    if (first > rowCount()) {
+        // 缓存与模型已经对不上（漏掉了某次变更），整列重新读取
+        fill(model, column, role);
+        return;
+    }
+    const int count = last - first + 1;
+    kinds_.insert(first, count, static_cast<quint8>(xTableCellValue::Null));
+    numbers_.insert(first, count, 0.0);
+    integers_.insert(first, count, 0);
+    texts_.insert(first, count, QString());
+    if (!others_.isEmpty()) others_.insert(first, count, QVariant());
+    update(model, column, role, first, last);
+}
+
+void xTableColumnCache::removeRows(int first, int last) {
+    first = qMax(first, 0);
+    last = qMin(last, rowCount() - 1);
+    if (last < first) return;
+    const int count = last - first + 1;
+    kinds_.remove(first, count);
+    numbers_.remove(first, count);
+    integers_.remove(first, count);
+    texts_.remove(first, count);
+    if (!others_.isEmpty()) others_.remove(first, count);
+}
+
+void xTableColumnCache::store(int row, const QVariant &data) {
+    xTableCellValue value = xTableCellValue::decode(data);
+    kinds_[row] = value.kind;
+    numbers_[row] = value.number;
+    integers_[row] = value.integer;
+    texts_[row] = std::move(value.text);
+    if (value.kind == xTableCellValue::Other) {
+        if (others_.isEmpty()) others_.resize(kinds_.size());
+        others_[row] = std::move(value.other);
+    } else if (!others_.isEmpty()) {
+        others_[row] = QVariant();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// 新条目先各自排好序，再与原有的有序条目归并，插入 k 行只需 O(n + k log k)
+template <typename T>
+static void mergeSorted(QVector<T> &entries, QVector<T> &fresh) {
+    if (fresh.isEmpty()) return;
+    std::sort(fresh.begin(), fresh.end());
+    const qsizetype middle = entries.size();
+    entries.append(fresh);
+    std::inplace_merge(entries.begin(), entries.begin() + middle, entries.end());
+}
+
+void xTableColumnIndex::clear() {
+    slots_.clear();
+    row_numbers_.clear();
+    row_texts_.clear();
+    numbers_.clear();
+    texts_.clear();
+    unordered_.clear();
+    loose_rows_ = xTableBitmap();
+}
+
+void xTableColumnIndex::fill(const QAbstractItemModel *model, int column, int role) {
+    clear();
+    column_ = column;
+    role_ = role;
+    if (!model) return;
+    const int rows = model->rowCount();
+    slots_.resize(rows);
+    row_numbers_.resize(rows);
+    row_texts_.resize(rows);
+    loose_rows_ = xTableBitmap(rows);
+    for (int row = 0; row < rows; ++row) {
+        classify(row, model->data(model->index(row, column), role));
+        switch (slots_.at(row)) {
+            case NumberSlot:
+                numbers_.append(NumberEntry{row_numbers_.at(row), row});
+                break;
+            case TextSlot:
+                texts_.append(TextEntry{row_texts_.at(row), row});
+                break;
+            default:
+                unordered_.append(row);
+                break;
+        }
+    }
+    // 整列一次排序，比逐行二分插入快得多
+    std::sort(numbers_.begin(), numbers_.end());
+    std::sort(texts_.begin(), texts_.end());
+}
+
+void xTableColumnIndex::update(const QAbstractItemModel *model, int first, int last) {
+    if (!model) return;
+    first = qMax(first, 0);
+    last = qMin(last, rowCount() - 1);
+    if (last < first) return;
+    if (qint64(last - first + 1) * 16 > rowCount()) {
+        // 改动范围占了整列的一大块，逐行挪动条目还不如整列重建
+        fill(model, column_, role_);
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        removeEntry(row);
+        classify(row, model->data(model->index(row, column_), role_));
+        addEntry(row);
+    }
+}
+
+void xTableColumnIndex::insertRows(const QAbstractItemModel *model, int first, int last) {
+    if (!model || last < first) return;
+    if (first > rowCount()) {
+        fill(model, column_, role_);
+        return;
+    }
+    // 插入点之后的行号整体后移；平移不改变条目之间的先后次序。末尾追加没有要挪的条目
+    const int count = last - first + 1;
+    if (first < rowCount()) {
+        for (NumberEntry &entry : numbers_) {
+            if (entry.row >= first) entry.row += count;
+        }
+        for (TextEntry &entry : texts_) {
+            if (entry.row >= first) entry.row += count;
+        }
+        auto tail = std::lower_bound(unordered_.begin(), unordered_.end(), first);
+        for (auto it = tail; it != unordered_.end(); ++it) *it += count;
+    }
+    slots_.insert(first, count, static_cast<quint8>(UnorderedSlot));
+    row_numbers_.insert(first, count, 0.0);
+    row_texts_.insert(first, count, QString());
+    loose_rows_.insert(first, count, true);
+
+    QVector<NumberEntry> numbers;
+    QVector<TextEntry> texts;
+    QVector<int> unordered;
+    for (int row = first; row <= last; ++row) {
+        classify(row, model->data(model->index(row, column_), role_));
+        switch (slots_.at(row)) {
+            case NumberSlot:
+                numbers.append(NumberEntry{row_numbers_.at(row), row});
+                break;
+            case TextSlot:
+                texts.append(TextEntry{row_texts_.at(row), row});
+                break;
+            default:
+                unordered.append(row);
+                break;
+        }
+    }
+    mergeSorted(numbers_, numbers);
+    mergeSorted(texts_, texts);
+    mergeSorted(unordered_, unordered);
+}
+
+void xTableColumnIndex::removeRows(int first, int last) {
+    first = qMax(first, 0);
+    last = qMin(last, rowCount() - 1);
+    if (last < first) return;
+    const int count = last - first + 1;
+    const auto removed = [&](int row) { return row >= first && row <= last; };
+    const auto shift = [&](int &row) {
+        if (row > last) row -= count;
+    };
+    numbers_.erase(std::remove_if(numbers_.begin(), numbers_.end(),
+                                  [&](const NumberEntry &entry) { return removed(entry.row); }),
+                   numbers_.end());
+    for (NumberEntry &entry : numbers_) shift(entry.row);
+    texts_.erase(std::remove_if(texts_.begin(), texts_.end(),
+                                [&](const TextEntry &entry) { return removed(entry.row); }),
+                 texts_.end());
+    for (TextEntry &entry : texts_) shift(entry.row);
+    unordered_.erase(std::remove_if(unordered_.begin(), unordered_.end(), removed),
+                     unordered_.end());
+    for (int &row : unordered_) shift(row);
+    slots_.remove(first, count);
+    row_numbers_.remove(first, count);
+    row_texts_.remove(first, count);
+    loose_rows_.remove(first, count);
+}
+
+void xTableColumnIndex::rangeRows(double min, double max, xTableBitmap &rows) const {
+    // min/max 只约束数值，文本和无法排序的单元格总能通过
+    rows = loose_rows_;
+    auto begin = std::lower_bound(numbers_.cbegin(), numbers_.cend(), min,
+                                  [](const NumberEntry &entry, double value) {
+                                      return entry.number < value;
+                                  });
+    auto end = std::upper_bound(begin, numbers_.cend(), max,
+                                [](double value, const NumberEntry &entry) {
+                                    return value < entry.number;
+                                });
+    for (auto it = begin; it < end; ++it) rows.setBit(it->row);
+}
+
+bool xTableColumnIndex::equalRows(const xTableCellValue &value, xTableBitmap &rows) const {
+    if (!value.isNumber() && value.kind != xTableCellValue::String) return false;
+    rows = xTableBitmap(rowCount());
+    if (value.isNumber()) {
+        // 整数相等必然 double 相等，反之不一定；多出来的候选由调用方用规则复核
+        auto begin = std::lower_bound(numbers_.cbegin(), numbers_.cend(), value.number,
+                                      [](const NumberEntry &entry, double number) {
+                                          return entry.number < number;
+                                      });
+        for (auto it = begin; it < numbers_.cend() && it->number == value.number; ++it) {
+            rows.setBit(it->row);
+        }
+    } else {
+        auto begin = std::lower_bound(texts_.cbegin(), texts_.cend(), value.text,
+                                      [](const TextEntry &entry, const QString &text) {
+                                          return entry.text.compare(text) < 0;
+                                      });
+        for (auto it = begin; it < texts_.cend() && it->text == value.text; ++it) {
+            rows.setBit(it->row);
+        }
+    }
+    // 布尔值与数字比较、以及自定义类型的相等语义不在索引里，一律留给规则判断
+    for (int row : unordered_) rows.setBit(row);
+    return true;
+}
+
+void xTableColumnIndex::classify(int row, const QVariant &data) {
+    double number = 0;
+    row_texts_[row] = QString();
+    if (data.typeId() == QMetaType::QString) {
+        slots_[row] = TextSlot;
+        row_texts_[row] = data.toString();
+    } else if (xTableCellValue::rangeNumber(data, number) && !qIsNaN(number)) {
+        slots_[row] = NumberSlot;
+        row_numbers_[row] = number;
+    } else {
+        slots_[row] = UnorderedSlot;
+    }
+    loose_rows_.setBit(row, slots_.at(row) != NumberSlot);
+}
+
+void xTableColumnIndex::addEntry(int row) {
+    switch (slots_.at(row)) {
+        case NumberSlot: {
+            const NumberEntry entry{row_numbers_.at(row), row};
+            numbers_.insert(std::lower_bound(numbers_.begin(), numbers_.end(), entry), entry);
+            break;
+        }
+        case TextSlot: {
+            const TextEntry entry{row_texts_.at(row), row};
+            texts_.insert(std::lower_bound(texts_.begin(), texts_.end(), entry), entry);
+            break;
+        }
+        default:
+            unordered_.insert(std::lower_bound(unordered_.begin(), unordered_.end(), row), row);
+            break;
+    }
+}
+
+void xTableColumnIndex::removeEntry(int row) {
+    switch (slots_.at(row)) {
+        case NumberSlot: {
+            const NumberEntry entry{row_numbers_.at(row), row};
+            auto it = std::lower_bound(numbers_.begin(), numbers_.end(), entry);
+            if (it != numbers_.end() && it->row == row) numbers_.erase(it);
+            break;
+        }
+        case TextSlot: {
+            const TextEntry entry{row_texts_.at(row), row};
+            auto it = std::lower_bound(texts_.begin(), texts_.end(), entry);
+            if (it != texts_.end() && it->row == row) texts_.erase(it);
+            break;
+        }
+        default: {
+            auto it = std::lower_bound(unordered_.begin(), unordered_.end(), row);
+            if (it != unordered_.end() && *it == row) unordered_.erase(it);
+            break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+quint32 xTableCategoryColumn::intern(const QString &text) {
+    auto it = lookup_.constFind(text);
+    if (it != lookup_.constEnd()) return it.value();
+    const quint32 code = quint32(categories_.size());
+    categories_.append(text);
+    lookup_.insert(text, code);
+    return code;
+}
+
+QVariant xTableCategoryColumn::value(int row) const {
+    const quint32 c = codes_.at(row);
+    return c == kNull ? QVariant() : QVariant(categories_.at(c));
+}
+
+void xTableCategoryColumn::setValue(int row, const QVariant &value) {
+    codes_[row] = value.isValid() ? intern(value.toString()) : kNull;
+}
+
+void xTableCategoryColumn::insert(int pos, int count) {
+    codes_.insert(pos, count, kNull);
+}
+
+void xTableCategoryColumn::remove(int pos, int count) {
+    codes_.remove(pos, count);
+    // 字典不随行收缩，不再用到的类别留给 compact() 统一清理
+}
+
+void xTableCategoryColumn::clear() {
+    codes_.clear();
+    categories_.clear();
+    lookup_.clear();
+    ++generation_;
+}
+
+bool xTableCategoryColumn::compact() {
+    const QVector<int> used = counts();
+    QVector<quint32> renumber(categories_.size(), kNull);
+    QVector<QString> kept;
+    for (int code = 0; code < categories_.size(); ++code) {
+        if (used.at(code) == 0) continue;
+        renumber[code] = quint32(kept.size());
+        kept.append(categories_.at(code));
+    }
+    if (kept.size() == categories_.size()) return false;
+    for (quint32 &code : codes_) {
+        if (code != kNull) code = renumber.at(code);
+    }
+    categories_ = kept;
+    lookup_.clear();
+    for (int code = 0; code < categories_.size(); ++code) {
+        lookup_.insert(categories_.at(code), quint32(code));
+    }
+    // 编号换了含义，按编号缓存的过滤和排序结果都要重算
+    ++generation_;
+    return true;
+}
+
+QVector<int> xTableCategoryColumn::ranks(Qt::CaseSensitivity cs, bool localeAware) const {
+    // 只排字典（通常几十项），与行数无关
+    QVector<int> order(categories_.size());
+    std::iota(order.begin(), order.end(), 0);
+    QVector<QCollatorSortKey> keys;
+    if (localeAware) {
+        QCollator collator;
+        collator.setCaseSensitivity(cs);
+        keys.reserve(categories_.size());
+        for (const QString &text : categories_) keys.append(collator.sortKey(text));
+    }
+    const auto compare = [&](int left, int right) {
+        return localeAware ? keys.at(left).compare(keys.at(right))
+                           : categories_.at(left).compare(categories_.at(right), cs);
+    };
+    std::sort(order.begin(), order.end(),
+              [&](int left, int right) { return compare(left, right) < 0; });
+    QVector<int> ranks(categories_.size());
+    int rank = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        if (i > 0 && compare(order.at(i - 1), order.at(i)) != 0) ++rank;
+        ranks[order.at(i)] = rank;
+    }
+    return ranks;
+}
+
+QVector<int> xTableCategoryColumn::counts() const {
+    QVector<int> counts(categories_.size());
+    for (quint32 c : codes_) {
+        if (c != kNull) ++counts[c];
+    }
+    return counts;
+}
+
+QVector<QVector<int>> xTableCategoryColumn::groups() const {
+    const QVector<int> sizes = counts();
+    QVector<QVector<int>> groups(categories_.size());
+    for (int c = 0; c < groups.size(); ++c) groups[c].reserve(sizes.at(c));
+    for (int row = 0; row < codes_.size(); ++row) {
+        if (codes_.at(row) != kNull) groups[codes_.at(row)].append(row);
+    }
+    return groups;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// 分类列只在按显示值或编辑值排序时可用
+static const xTableCategoryColumn *sortCategories(const QAbstractItemModel *model, int column,
+                                                  int role) {
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return nullptr;
+    const auto *table = qobject_cast<const xAbstractTableModel *>(model);
+    return table ? table->categoryColumn(column) : nullptr;
+}
+
+// 排序时的大类：数字在前，文本其次，空值最后（与 QSortFilterProxyModel 升序时空值沉底一致）
+static int sortClass(xTableCellValue::Kind kind) {
+    if (xTableCellValue::isNumber(kind)) return 0;
+    return kind == xTableCellValue::Null ? 2 : 1;
+}
+
+bool xTableSortKeys::lessThan(int left, int right) const {
+    const auto leftKind = static_cast<xTableCellValue::Kind>(kinds_.at(left));
+    const auto rightKind = static_cast<xTableCellValue::Kind>(kinds_.at(right));
+    const int leftClass = sortClass(leftKind);
+    const int rightClass = sortClass(rightKind);
+    if (leftClass != rightClass) return leftClass < rightClass;
+    switch (leftClass) {
+        case 0:
+            if (xTableCellValue::isIntegral(leftKind) && xTableCellValue::isIntegral(rightKind)) {
+                return integers_.at(left) < integers_.at(right);
+            }
+            return numbers_.at(left) < numbers_.at(right);
+        case 1:
+            if (locale_aware_) {
+                return collation_keys_.at(left).compare(collation_keys_.at(right)) < 0;
+            }
+            return texts_.at(left).compare(texts_.at(right), case_sensitivity_) < 0;
+        default:
+            return false;
+    }
+}
+
+QVector<int> xTableSortKeys::ranks(const QVector<xTableSortKeys> &keys,
+                                   const QVector<bool> &reversed,
+                                   const std::atomic_bool *cancelled,
+                                   QVector<int> *sortedRows) {
+    if (keys.isEmpty()) return {};
+    const int rows = keys.first().rowCount();
+    for (const xTableSortKeys &key : keys) {
+        if (key.rowCount() != rows) return {};
+    }
+    QVector<int> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+
+    // LSD：从最次要的列排到最主要的列，每一趟都是稳定排序，前一趟的次序保留在并列项里
+    for (int i = keys.size() - 1; i >= 0; --i) {
+        if (!keys.at(i).sortRows(order, reversed.value(i), cancelled)) return {};
+    }
+
+    const auto same = [&keys](int left, int right) {
+        for (const xTableSortKeys &key : keys) {
+            if (key.lessThan(left, right) || key.lessThan(right, left)) return false;
+        }
+        return true;
+    };
+    QVector<int> ranks(rows);
+    int rank = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        if (i > 0 && !same(order.at(i - 1), order.at(i))) ++rank;
+        ranks[order.at(i)] = rank;
+    }
+    if (sortedRows) *sortedRows = std::move(order);
+    return ranks;
+}
+
+bool xTableSortKeys::sortRows(QVector<int> &order, bool reversed,
+                              const std::atomic_bool *cancelled) const {
+    const auto isCancelled = [cancelled]() {
+        return cancelled && cancelled->load(std::memory_order_relaxed);
+    };
+
+    QVector<quint64> radix;
+    if (radixKeys(radix)) {
+        // 纯数值（含布尔）列：空值单独分出，其余按字节做线性时间的基数排序
+        QVector<int> values;
+        QVector<int> nulls;
+        values.reserve(order.size());
+        for (int row : std::as_const(order)) {
+            if (kinds_.at(row) == xTableCellValue::Null)
+                nulls.append(row);
+            else
+                values.append(row);
+        }
+        QVector<int> buffer(values.size());
+        for (int shift = 0; shift < 64; shift += 8) {
+            if (isCancelled()) return false;
+            int counts[257] = {};
+            for (int row : std::as_const(values)) {
+                const quint64 key = reversed ? ~radix.at(row) : radix.at(row);
+                ++counts[((key >> shift) & 0xff) + 1];
+            }
+            // 这一字节所有行都相同，不必搬动
+            if (std::find(counts + 1, counts + 257, values.size()) != counts + 257) continue;
+            for (int b = 1; b < 257; ++b) counts[b] += counts[b - 1];
+            for (int row : std::as_const(values)) {
+                const quint64 key = reversed ? ~radix.at(row) : radix.at(row);
+                buffer[counts[(key >> shift) & 0xff]++] = row;
+            }
+            values.swap(buffer);
+        }
+        // 升序时空值在最后，降序时整体反过来，空值在最前
+        order = reversed ? nulls + values : values + nulls;
+        return true;
+    }
+
+    const auto less = [this, reversed](int left, int right) {
+        return reversed ? lessThan(right, left) : lessThan(left, right);
+    };
+    const int rows = order.size();
+    // 先分块排序再逐层两两归并，结果与整体 stable_sort 相同，但每一步之间都能响应取消
+    constexpr int kRunRows = 64 * 1024;
+    for (int first = 0; first < rows; first += kRunRows) {
+        if (isCancelled()) return false;
+        const int last = qMin(first + kRunRows, rows);
+        std::stable_sort(order.begin() + first, order.begin() + last, less);
+    }
+    for (qint64 width = kRunRows; width < rows; width *= 2) {
+        for (qint64 first = 0; first + width < rows; first += 2 * width) {
+            if (isCancelled()) return false;
+            std::inplace_merge(order.begin() + first, order.begin() + first + width,
+                               order.begin() + qMin<qint64>(first + 2 * width, rows), less);
+        }
+    }
+    return true;
+}
+
+bool xTableSortKeys::radixKeys(QVector<quint64> &keys) const {
+    bool integral = true;
+    for (quint8 kind : kinds_) {
+        const auto k = static_cast<xTableCellValue::Kind>(kind);
+        if (sortClass(k) == 1) return false;
+        if (xTableCellValue::isNumber(k) && !xTableCellValue::isIntegral(k)) integral = false;
+    }
+    // 映射成保序的无符号整数：整数翻转符号位；浮点数负数按位取反、非负数置符号位
+    keys.resize(rowCount());
+    for (int row = 0; row < rowCount(); ++row) {
+        if (kinds_.at(row) == xTableCellValue::Null) continue;
+        if (integral) {
+            keys[row] = quint64(integers_.at(row)) ^ (quint64(1) << 63);
+            continue;
+        }
+        const double number = numbers_.at(row) == 0 ? 0.0 : numbers_.at(row);  // -0 == 0
+        quint64 bits;
+        std::memcpy(&bits, &number, sizeof(bits));
+        keys[row] = (bits >> 63) ? ~bits : bits | (quint64(1) << 63);
+    }
+    return true;
+}
+
+void xTableSortKeys::clear() {
+    column_ = -1;
+    kinds_.clear();
+    numbers_.clear();
+    integers_.clear();
+    texts_.clear();
+    collation_keys_.clear();
+    category_ranks_.clear();
+    category_generation_ = -1;
+    values_.clear();
+}
+
+void xTableSortKeys::fill(const QAbstractItemModel *model, int column, int role,
+                          Qt::CaseSensitivity cs, bool localeAware) {
+    clear();
+    if (!model) return;
+    column_ = column;
+    role_ = role;
+    case_sensitivity_ = cs;
+    locale_aware_ = localeAware;
+    collator_ = QCollator();
+    collator_.setCaseSensitivity(cs);
+    insertRows(model, 0, model->rowCount() - 1);
+}
+
+void xTableSortKeys::capture(const QAbstractItemModel *model, int column, int role,
+                             Qt::CaseSensitivity cs, bool localeAware) {
+    clear();
+    if (!model) return;
+    column_ = column;
+    role_ = role;
+    case_sensitivity_ = cs;
+    locale_aware_ = localeAware;
+    collator_ = QCollator();
+    collator_.setCaseSensitivity(cs);
+    const int rows = model->rowCount();
+    insertEmptyRows(0, rows);
+    if (sortCategories(model, column_, role_)) {
+        update(model, 0, rows - 1);  // 分类列只读编码，没有要交给工作线程的活
+        return;
+    }
+    // 数字解析和文本排序键留给 build()，这里只拷贝（QString 隐式共享，只加引用计数）
+    values_.resize(rows);
+    for (int row = 0; row < rows; ++row) {
+        values_[row] = model->data(model->index(row, column_), role_);
+    }
+}
+
+bool xTableSortKeys::build(const std::atomic_bool *cancelled) {
+    for (int row = 0; row < values_.size(); ++row) {
+        if ((row & 0xffff) == 0 && cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        store(row, values_.at(row));
+    }
+    values_ = QVector<QVariant>();
+    return true;
+}
+
+void xTableSortKeys::update(const QAbstractItemModel *model, int first, int last) {
+    if (!model || column_ < 0) return;
+    first = qMax(first, 0);
+    last = qMin(last, rowCount() - 1);
+    if (const xTableCategoryColumn *categories = sortCategories(model, column_, role_)) {
+        if (category_ranks_.size() != categories->categoryCount() ||
+            category_generation_ != categories->generation()) {
+            // 新类别可能排在已有类别之间，字典压缩后编号也会变，名次整体变化，整列重新取键
+            category_ranks_ = categories->ranks(case_sensitivity_, locale_aware_);
+            category_generation_ = categories->generation();
+            first = 0;
+            last = rowCount() - 1;
+        }
+        for (int row = first; row <= last; ++row) storeCategory(row, *categories);
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        store(row, model->data(model->index(row, column_), role_));
+    }
+}
+
+void xTableSortKeys::insertRows(const QAbstractItemModel *model, int first, int last) {
+    if (!model || column_ < 0 || last < first) return;
+    if (first > rowCount()) {
+        fill(model, column_, role_, case_sensitivity_, locale_aware_);
+        return;
+    }
+    insertEmptyRows(first, last - first + 1);
+    update(model, first, last);
+}
+
+void xTableSortKeys::insertEmptyRows(int first, int count) {
+    if (count <= 0) return;
+    kinds_.insert(first, count, static_cast<quint8>(xTableCellValue::Null));
+    numbers_.insert(first, count, 0.0);
+    integers_.insert(first, count, 0);
+    if (locale_aware_)
+        collation_keys_.insert(first, count, collator_.sortKey(QString()));
+    else
+        texts_.insert(first, count, QString());
+}
+
+void xTableSortKeys::removeRows(int first, int last) {
+    first = qMax(first, 0);
+    last = qMin(last, rowCount() - 1);
+    if (last < first) return;
+    const int count = last - first + 1;
+    kinds_.remove(first, count);
+    numbers_.remove(first, count);
+    integers_.remove(first, count);
+    if (locale_aware_)
+        collation_keys_.remove(first, count);
+    else
+        texts_.remove(first, count);
+}
+
+void xTableSortKeys::store(int row, const QVariant &data) {
+    const xTableCellValue value = xTableCellValue::decode(data);
+    kinds_[row] = value.kind;
+    numbers_[row] = value.number;
+    integers_[row] = value.integer;
+    // 数字和空值不会走到文本比较，不必为它们生成排序键
+    if (sortClass(value.kind) != 1) return;
+    if (locale_aware_)
+        collation_keys_[row] = collator_.sortKey(value.text);
+    else
+        texts_[row] = value.text;
+}
+
+void xTableSortKeys::storeCategory(int row, const xTableCategoryColumn &categories) {
+    // 追加模式的占位行不在分类列里，按空值处理
+    const quint32 code =
+        row < categories.rowCount() ? categories.code(row) : xTableCategoryColumn::kNull;
+    if (code == xTableCategoryColumn::kNull) {
+        kinds_[row] = static_cast<quint8>(xTableCellValue::Null);
+        return;
+    }
+    // 名次与文本顺序一致；整列都是整数键，排序走基数排序
+    const int rank = category_ranks_.at(code);
+    kinds_[row] = static_cast<quint8>(xTableCellValue::LongLong);
+    integers_[row] = rank;
+    numbers_[row] = rank;
+}
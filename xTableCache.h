@@ -0,0 +1,354 @@
+#pragma once
+// ***************************************************************
+//  xTableCache   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QCollator>
+#include <atomic>
+
+class QAbstractItemModel;
+
+// One cell value decoded out of its QVariant once, so hot loops compare plain types.
+struct xTableCellValue {
+    enum Kind : quint8 { Null, Bool, Int, LongLong, Float, Double, String, Other };
+
+    Kind kind = Null;
+    double number = 0;   // valid for every numeric kind; Other: numeric zce::Any value or NaN
+    qint64 integer = 0;  // valid for Bool / Int / LongLong
+    QString text;        // QVariant::toString() of the value
+    QVariant other;      // original value, only kept for Kind::Other
+
+    static xTableCellValue decode(const QVariant &data);
+
+    // value min/max filters compare against: any numeric type but bool, numeric zce::Any included
+    static bool rangeNumber(const QVariant &data, double &number);
+
+    // kinds whose number takes part in min/max filters (NaN never falls outside the bounds)
+    static bool isRanged(Kind kind) { return (kind >= Int && kind <= Double) || kind == Other; }
+
+    static bool isNumber(Kind kind) { return kind >= Bool && kind <= Double; }
+
+    static bool isIntegral(Kind kind) { return kind >= Bool && kind <= LongLong; }
+
+    bool isNumber() const { return isNumber(kind); }
+
+    bool isIntegral() const { return isIntegral(kind); }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Packed one-bit-per-row set (64 rows per word).
+// Worker threads may write through words() as long as each one owns whole words.
+class xTableBitmap {
+    QVector<quint64> words_;
+    int size_ = 0;
+
+  public:
+    xTableBitmap() = default;
+
+    explicit xTableBitmap(int size, bool value = false);
+
+    int size() const { return size_; }
+
+    bool isEmpty() const { return size_ == 0; }
+
+    bool testBit(int i) const { return (words_.at(i >> 6) >> (i & 63)) & 1; }
+
+    void setBit(int i, bool value = true) {
+        const quint64 mask = quint64(1) << (i & 63);
+        if (value)
+            words_[i >> 6] |= mask;
+        else
+            words_[i >> 6] &= ~mask;
+    }
+
+    void fill(bool value);
+
+    void resize(int size, bool value = false);
+
+    // shift the bits at and after pos, like QVector::insert / remove
+    void insert(int pos, int count, bool value = false);
+
+    void remove(int pos, int count);
+
+    int count() const;
+
+    // bits pos .. pos + count - 1 as a new bitmap
+    xTableBitmap mid(int pos, int count) const;
+
+    // word-wise AND over the common prefix; a plain 64-bit loop the compiler vectorizes
+    xTableBitmap &operator&=(const xTableBitmap &other);
+
+    int wordCount() const { return words_.size(); }
+
+    quint64 *words() { return words_.data(); }
+
+    const quint64 *constWords() const { return words_.constData(); }
+
+  private:
+    void clearTail();
+
+    // the 64 bits starting at pos (any alignment); bits past the end read as 0
+    quint64 wordAt(int pos) const;
+
+    // overwrite the n (1..64) bits at pos with the low bits of bits
+    void storeBits(int pos, quint64 bits, int n);
+
+    // bits 0 .. n - 1 of src to pos .. pos + n - 1, 64 at a time
+    void storeBitmap(int pos, const xTableBitmap &src, int n);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Decoded values of one source column, stored column-wise.
+// Filled once from the model, then patched from dataChanged / rowsInserted / rowsRemoved.
+class xTableColumnCache {
+    QVector<quint8> kinds_;
+    QVector<double> numbers_;
+    QVector<qint64> integers_;
+    QVector<QString> texts_;
+    QVector<QVariant> others_;  // stays empty until a Kind::Other cell shows up
+
+  public:
+    int rowCount() const { return kinds_.size(); }
+
+    xTableCellValue::Kind kind(int row) const {
+        return static_cast<xTableCellValue::Kind>(kinds_.at(row));
+    }
+
+    double number(int row) const { return numbers_.at(row); }
+
+    qint64 integer(int row) const { return integers_.at(row); }
+
+    const QString &text(int row) const { return texts_.at(row); }
+
+    // same result as QVariant::operator== between the cached cell and value
+    bool equals(int row, const xTableCellValue &value) const;
+
+    void clear();
+
+    void fill(const QAbstractItemModel *model, int column, int role);
+
+    void update(const QAbstractItemModel *model, int column, int role, int first, int last);
+
+    void insertRows(const QAbstractItemModel *model, int column, int role, int first, int last);
+
+    void removeRows(int first, int last);
+
+  private:
+    void store(int row, const QVariant &data);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Sorted secondary index of one source column (value -> rows) for range and equality filters.
+// Lookups return a superset of the matching rows: cells the index cannot order (empty, bool,
+// non-numeric Other) always come back, and callers confirm each candidate with the rule itself.
+class xTableColumnIndex {
+    enum Slot : quint8 { NumberSlot, TextSlot, UnorderedSlot };
+
+    struct NumberEntry {
+        double number;
+        int row;
+        bool operator<(const NumberEntry &other) const {
+            return number < other.number || (number == other.number && row < other.row);
+        }
+    };
+
+    struct TextEntry {
+        QString text;
+        int row;
+        bool operator<(const TextEntry &other) const {
+            const int c = text.compare(other.text);
+            return c < 0 || (c == 0 && row < other.row);
+        }
+    };
+
+    int column_ = -1;
+    int role_ = Qt::DisplayRole;
+    QVector<quint8> slots_;        // per row: which list below holds it
+    QVector<double> row_numbers_;  // per row key, to find its entry again on updates
+    QVector<QString> row_texts_;
+    QVector<NumberEntry> numbers_;  // ascending (number, row)
+    QVector<TextEntry> texts_;      // ascending (text, row)
+    QVector<int> unordered_;        // ascending rows
+    xTableBitmap loose_rows_;       // text and unordered rows, which pass every min/max
+
+  public:
+    int column() const { return column_; }
+
+    int rowCount() const { return slots_.size(); }
+
+    void clear();
+
+    void fill(const QAbstractItemModel *model, int column, int role = Qt::DisplayRole);
+
+    void update(const QAbstractItemModel *model, int first, int last);
+
+    void insertRows(const QAbstractItemModel *model, int first, int last);
+
+    void removeRows(int first, int last);
+
+    // rows that may pass min/max: numbers inside [min, max], plus every text and unordered cell
+    void rangeRows(double min, double max, xTableBitmap &rows) const;
+
+    // rows that may compare equal to value; false when value's kind is not indexed
+    bool equalRows(const xTableCellValue &value, xTableBitmap &rows) const;
+
+  private:
+    void classify(int row, const QVariant &data);
+
+    void addEntry(int row);
+
+    void removeEntry(int row);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Categorical column: a few distinct strings repeated over many rows, stored as one integer
+// code per row into a per-column dictionary. Codes are handed out in first-seen order and
+// stay valid until clear(), so filters, sorts and grouping can work on the codes alone.
+class xTableCategoryColumn {
+    QVector<quint32> codes_;        // row -> code, kNull for an empty cell
+    QVector<QString> categories_;   // code -> text
+    QHash<QString, quint32> lookup_;
+    int generation_ = 0;            // bumped whenever existing codes change meaning
+
+  public:
+    static constexpr quint32 kNull = 0xffffffffu;
+
+    int rowCount() const { return codes_.size(); }
+
+    int categoryCount() const { return categories_.size(); }
+
+    quint32 code(int row) const { return codes_.at(row); }
+
+    const QVector<quint32> &codes() const { return codes_; }
+
+    const QVector<QString> &categories() const { return categories_; }
+
+    // results cached per code stay valid while this is unchanged and categoryCount() has
+    // only grown
+    int generation() const { return generation_; }
+
+    const QString &category(quint32 code) const { return categories_.at(code); }
+
+    // code of text, kNull when it is not in the dictionary
+    quint32 find(const QString &text) const { return lookup_.value(text, kNull); }
+
+    // code of text, adding it to the dictionary when new
+    quint32 intern(const QString &text);
+
+    // the category text, invalid for an empty cell
+    QVariant value(int row) const;
+
+    // an invalid value empties the cell, anything else is stored by its string form
+    void setValue(int row, const QVariant &value);
+
+    void setCode(int row, quint32 code) { codes_[row] = code; }
+
+    // new rows are empty
+    void insert(int pos, int count);
+
+    void remove(int pos, int count);
+
+    void clear();
+
+    // drop the categories no row uses and renumber the rest in their old order; false when
+    // every category is in use
+    bool compact();
+
+    // Dense rank of every code when the categories are ordered as text the way
+    // xTableSortKeys orders them; categories comparing equal share a rank.
+    QVector<int> ranks(Qt::CaseSensitivity cs = Qt::CaseSensitive, bool localeAware = false) const;
+
+    // rows per code
+    QVector<int> counts() const;
+
+    // rows of every code, ascending
+    QVector<QVector<int>> groups() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Typed sort key of every row in one source column, extracted once per sort.
+// Orders like QSortFilterProxyModel::lessThan: numbers, then text, empty cells last.
+// Categorical columns of an xAbstractTableModel are keyed by category rank instead of text.
+class xTableSortKeys {
+    int column_ = -1;
+    int role_ = Qt::DisplayRole;
+    Qt::CaseSensitivity case_sensitivity_ = Qt::CaseSensitive;
+    bool locale_aware_ = false;
+    QCollator collator_;
+    QVector<quint8> kinds_;  // xTableCellValue::Kind
+    QVector<double> numbers_;
+    QVector<qint64> integers_;
+    QVector<QString> texts_;                    // only when not locale aware
+    QVector<QCollatorSortKey> collation_keys_;  // only when locale aware
+    QVector<int> category_ranks_;  // code -> rank when the column is categorical
+    int category_generation_ = -1;  // xTableCategoryColumn::generation() of category_ranks_
+    QVector<QVariant> values_;     // raw cells copied by capture(), keyed by build()
+
+  public:
+    int column() const { return column_; }
+
+    int rowCount() const { return kinds_.size(); }
+
+    // keys were built with these sort settings
+    bool matches(int role, Qt::CaseSensitivity cs, bool localeAware) const {
+        return role_ == role && case_sensitivity_ == cs && locale_aware_ == localeAware;
+    }
+
+    bool lessThan(int left, int right) const;
+
+    // Dense rank of every row when sorted by keys[0], then keys[1], ... (reversed[i] flips
+    // keys[i]); equal rows share one rank. Returns an empty vector once *cancelled turns true.
+    // sortedRows, when given, receives the rows in that order.
+    static QVector<int> ranks(const QVector<xTableSortKeys> &keys, const QVector<bool> &reversed,
+                              const std::atomic_bool *cancelled = nullptr,
+                              QVector<int> *sortedRows = nullptr);
+
+    void clear();
+
+    void fill(const QAbstractItemModel *model, int column, int role, Qt::CaseSensitivity cs,
+              bool localeAware);
+
+    // like fill(), but only copies the raw cells (the model is read on its own thread);
+    // build() turns them into keys on any thread. Categorical columns are keyed at once.
+    void capture(const QAbstractItemModel *model, int column, int role, Qt::CaseSensitivity cs,
+                 bool localeAware);
+
+    // false once *cancelled turns true
+    bool build(const std::atomic_bool *cancelled = nullptr);
+
+    // room for count empty keys at first, to be read by update()
+    void insertEmptyRows(int first, int count);
+
+    void update(const QAbstractItemModel *model, int first, int last);
+
+    void insertRows(const QAbstractItemModel *model, int first, int last);
+
+    void removeRows(int first, int last);
+
+  private:
+    // stable sort of order by this key; numeric columns use an LSD radix sort
+    bool sortRows(QVector<int> &order, bool reversed, const std::atomic_bool *cancelled) const;
+
+    // order-preserving unsigned key per row, false when the column holds text
+    bool radixKeys(QVector<quint64> &keys) const;
+
+    void store(int row, const QVariant &data);
+
+    // rank of the row's category as an integer key; rows past the categories stay empty
+    void storeCategory(int row, const xTableCategoryColumn &categories);
+};
@@ -0,0 +1,342 @@
+// ***************************************************************
+//  xTableClipboard   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableClipboard.h"
+#include <QAbstractItemModel>
+#include <QApplication>
+#include <QClipboard>
+#include <QMimeData>
+#include <QProgressDialog>
+#include <QThreadPool>
+#include <QTimer>
+#include <algorithm>
+#include <limits>
+
+// GUI 线程每轮事件循环读这么多个单元格，作为一块交给工作线程
+static constexpr int kChunkCells = 64 * 1024;
+
+static const QLatin1String kHtmlHead("<html><head><meta charset=\"utf-8\"></head><body><table>\n");
+static const QLatin1String kHtmlTail("</table></body></html>");
+
+// 含分隔符、引号或换行的字段加引号，内部引号写两遍
+static void appendCsvField(QString &csv, const QString &cell) {
+    bool quote = false;
+    for (QChar ch : cell) {
+        if (ch == QLatin1Char(',') || ch == QLatin1Char('"') || ch == QLatin1Char('\n') ||
+            ch == QLatin1Char('\r')) {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote) {
+        csv += cell;
+        return;
+    }
+    csv += QLatin1Char('"');
+    for (QChar ch : cell) {
+        if (ch == QLatin1Char('"')) csv += QLatin1Char('"');
+        csv += ch;
+    }
+    csv += QLatin1Char('"');
+}
+
+// cells 按行连续存放，widths 是每行的单元格数；三种格式一遍写完
+static xTableCopyText serializeRows(const QVector<QString> &cells, const QVector<int> &widths) {
+    qint64 chars = 0;
+    for (const QString &cell : cells) chars += cell.size();
+    xTableCopyText text;
+    text.tsv.reserve(chars + cells.size());
+    text.csv.reserve(chars + cells.size() * 2);
+    text.html.reserve(chars + cells.size() * 9 + widths.size() * 10);
+
+    int i = 0;
+    for (int width : widths) {
+        text.html += QLatin1String("<tr>");
+        for (int c = 0; c < width; ++c, ++i) {
+            const QString &cell = cells.at(i);
+            if (c > 0) {
+                text.tsv += QLatin1Char('\t');
+                text.csv += QLatin1Char(',');
+            }
+            text.tsv += cell;
+            appendCsvField(text.csv, cell);
+            text.html += QLatin1String("<td>");
+            text.html += cell.toHtmlEscaped();
+            text.html += QLatin1String("</td>");
+        }
+        text.tsv += QLatin1Char('\n');
+        text.csv += QLatin1String("\r\n");
+        text.html += QLatin1String("</tr>\n");
+    }
+    return text;
+}
+
+// 在 first 处插入 count 行：之后的段后移，插在段中间的段拆成两截（新行不在选区里）
+static void insertBandRows(QVector<xSelectionBand> &bands, int first, int count) {
+    const int last = first + count - 1;
+    for (int i = 0; i < bands.size(); ++i) {
+        xSelectionBand &band = bands[i];
+        if (band.first >= first) {
+            band.first += count;
+            band.last += count;
+        } else if (band.last >= first) {
+            xSelectionBand tail = band;
+            tail.first = last + 1;
+            tail.last += count;
+            band.last = first - 1;
+            bands.insert(++i, tail);
+        }
+    }
+}
+
+// 删掉 first..last 行：这些行不再复制，其后的行前移；段两端各自换算，空了的段去掉
+static void removeBandRows(QVector<xSelectionBand> &bands, int first, int last) {
+    const int count = last - first + 1;
+    const auto shift = [first, last, count](int row, int inside) {
+        return row < first ? row : (row > last ? row - count : inside);
+    };
+    for (xSelectionBand &band : bands) {
+        band.first = shift(band.first, first);
+        band.last = shift(band.last, first - 1);
+    }
+    bands.erase(std::remove_if(bands.begin(), bands.end(),
+                               [](const xSelectionBand &band) { return band.first > band.last; }),
+                bands.end());
+}
+
+// 各块按行序拼接；纯文本与旧的复制结果一致，末尾不带换行
+static QMimeData *joinChunks(const QVector<xTableCopyText> &chunks) {
+    qint64 tsvSize = 0;
+    qint64 csvSize = 0;
+    qint64 htmlSize = kHtmlHead.size() + kHtmlTail.size();
+    for (const xTableCopyText &chunk : chunks) {
+        tsvSize += chunk.tsv.size();
+        csvSize += chunk.csv.size();
+        htmlSize += chunk.html.size();
+    }
+    QString tsv;
+    QString csv;
+    QString html;
+    tsv.reserve(tsvSize);
+    csv.reserve(csvSize);
+    html.reserve(htmlSize);
+    html += kHtmlHead;
+    for (const xTableCopyText &chunk : chunks) {
+        tsv += chunk.tsv;
+        csv += chunk.csv;
+        html += chunk.html;
+    }
+    html += kHtmlTail;
+    tsv.chop(1);
+
+    auto *mime = new QMimeData;
+    mime->setText(tsv);
+    mime->setData(QStringLiteral("text/csv"), csv.toUtf8());
+    mime->setHtml(html);
+    return mime;
+}
+
+xTableClipboardCopy::xTableClipboardCopy(QAbstractItemModel *model, QVector<xSelectionBand> bands,
+                                         QWidget *dialogParent)
+    : QObject(dialogParent),
+      model_(model),
+      bands_(std::move(bands)),
+      cancelled_(std::make_shared<std::atomic_bool>(false)),
+      pool_(new QThreadPool(this)),
+      read_timer_(new QTimer(this)) {
+    total_cells_ = cellCount(bands_);
+    for (const xSelectionBand &band : std::as_const(bands_)) max_row_ = qMax(max_row_, band.last);
+    read_timer_->setInterval(0);
+    connect(read_timer_, &QTimer::timeout, this, &xTableClipboardCopy::readChunk);
+
+    progress_ = new QProgressDialog(tr("Copying %1 cells...").arg(total_cells_), tr("Cancel"), 0,
+                                    1000, dialogParent);
+    progress_->setWindowModality(Qt::WindowModal);
+    progress_->setMinimumDuration(400);
+    progress_->setAutoClose(false);
+    progress_->setAutoReset(false);
+    connect(progress_, &QProgressDialog::canceled, this, &xTableClipboardCopy::cancel);
+}
+
+xTableClipboardCopy::~xTableClipboardCopy() {
+    cancelled_->store(true);
+    pool_->waitForDone();
+    if (progress_) progress_->deleteLater();
+}
+
+qint64 xTableClipboardCopy::cellCount(const QVector<xSelectionBand> &bands) {
+    qint64 cells = 0;
+    for (const xSelectionBand &band : bands) {
+        qint64 columns = 0;
+        for (const auto &span : band.columns) columns += span.second - span.first + 1;
+        cells += columns * (band.last - band.first + 1);
+    }
+    return cells;
+}
+
+QMimeData *xTableClipboardCopy::mimeData(const QAbstractItemModel *model,
+                                         const QVector<xSelectionBand> &bands) {
+    QVector<QString> cells;
+    QVector<int> widths;
+    cells.reserve(int(qMin<qint64>(cellCount(bands), std::numeric_limits<int>::max())));
+    for (const xSelectionBand &band : bands) {
+        int width = 0;
+        for (const auto &span : band.columns) width += span.second - span.first + 1;
+        for (int row = band.first; row <= band.last; ++row) {
+            for (const auto &span : band.columns) {
+                for (int col = span.first; col <= span.second; ++col) {
+                    cells.append(model->index(row, col).data(Qt::DisplayRole).toString());
+                }
+            }
+            widths.append(width);
+        }
+    }
+    return joinChunks({serializeRows(cells, widths)});
+}
+
+void xTableClipboardCopy::start() {
+    if (!model_ || bands_.isEmpty()) {
+        finish(false);
+        return;
+    }
+    // 行的插入删除平移尚未读的行号；重置、重排或列变化后行列无从对应，只能放弃
+    model_connections_ << connect(model_, &QAbstractItemModel::rowsInserted, this,
+                                  &xTableClipboardCopy::onRowsInserted);
+    model_connections_ << connect(model_, &QAbstractItemModel::rowsRemoved, this,
+                                  &xTableClipboardCopy::onRowsRemoved);
+    const auto abort = [this]() { cancel(); };
+    model_connections_ << connect(model_, &QAbstractItemModel::modelReset, this, abort);
+    model_connections_ << connect(model_, &QAbstractItemModel::layoutChanged, this, abort);
+    model_connections_ << connect(model_, &QAbstractItemModel::rowsMoved, this, abort);
+    model_connections_ << connect(model_, &QAbstractItemModel::columnsInserted, this, abort);
+    model_connections_ << connect(model_, &QAbstractItemModel::columnsRemoved, this, abort);
+    model_connections_ << connect(model_, &QAbstractItemModel::columnsMoved, this, abort);
+    read_timer_->start();
+}
+
+void xTableClipboardCopy::cancel() { finish(false); }
+
+void xTableClipboardCopy::readChunk() {
+    if (!model_) {
+        finish(false);
+        return;
+    }
+    // 工作线程跟不上时先停读，等有块写完再继续，免得读好的单元格文本越积越多
+    if (chunks_pending_ >= qMax(pool_->maxThreadCount(), 1) * 2) {
+        read_timer_->stop();
+        return;
+    }
+
+    QVector<QString> cells;
+    QVector<int> widths;
+    cells.reserve(kChunkCells);
+    while (hasUnread() && cells.size() < kChunkCells) {
+        if (current_.isEmpty()) {
+            // 读到下一段时才把期间的行变动补算上去；段可能被拆开或整段删掉
+            const qint64 before = cellCount({bands_.at(band_)});
+            current_ = {bands_.at(band_++)};
+            for (const RowShift &shift : std::as_const(shifts_)) {
+                if (shift.count > 0) {
+                    insertBandRows(current_, shift.first, shift.count);
+                } else {
+                    removeBandRows(current_, shift.first, shift.first - shift.count - 1);
+                }
+            }
+            total_cells_ += cellCount(current_) - before;
+            continue;
+        }
+        xSelectionBand &band = current_.first();
+        int width = 0;
+        for (const auto &span : std::as_const(band.columns)) {
+            for (int col = span.first; col <= span.second; ++col, ++width) {
+                cells.append(model_->index(band.first, col).data(Qt::DisplayRole).toString());
+            }
+        }
+        widths.append(width);
+        if (++band.first > band.last) current_.removeFirst();
+    }
+    read_cells_ += cells.size();
+    if (!hasUnread()) read_timer_->stop();
+    if (cells.isEmpty()) {
+        // 剩下的段都已被删光
+        if (chunks_pending_ == 0) finish(true);
+        return;
+    }
+
+    const int chunk = chunks_.size();
+    chunks_.append({});
+    ++chunks_pending_;
+    pool_->start([this, chunk, cells = std::move(cells), widths = std::move(widths),
+                  cancelled = cancelled_]() {
+        if (cancelled->load()) return;
+        const xTableCopyText text = serializeRows(cells, widths);
+        if (cancelled->load()) return;
+        QMetaObject::invokeMethod(
+            this,
+            [this, chunk, text, count = qint64(cells.size()), cancelled]() {
+                if (!cancelled->load()) onChunkSerialized(chunk, text, count);
+            },
+            Qt::QueuedConnection);
+    });
+    updateProgress();
+}
+
+void xTableClipboardCopy::onRowsInserted(const QModelIndex &parent, int first, int last) {
+    // 追加在末尾是实时表格的常态，不必记下
+    if (parent.isValid() || first > max_row_) return;
+    const int count = last - first + 1;
+    // 正在读的段当场平移，其余的段记下变动，读到时再补算
+    insertBandRows(current_, first, count);
+    shifts_.append({first, count});
+    max_row_ += count;
+}
+
+void xTableClipboardCopy::onRowsRemoved(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid() || first > max_row_) return;
+    const qint64 before = cellCount(current_);
+    removeBandRows(current_, first, last);
+    total_cells_ += cellCount(current_) - before;
+    shifts_.append({first, -(last - first + 1)});
+    updateProgress();
+}
+
+void xTableClipboardCopy::onChunkSerialized(int chunk, const xTableCopyText &text,
+                                            qint64 cells) {
+    chunks_[chunk] = text;
+    --chunks_pending_;
+    serialized_cells_ += cells;
+    updateProgress();
+    if (hasUnread()) {
+        if (!done_ && !read_timer_->isActive()) read_timer_->start();
+    } else if (chunks_pending_ == 0) {
+        finish(true);
+    }
+}
+
+void xTableClipboardCopy::updateProgress() {
+    if (!progress_ || total_cells_ == 0) return;
+    // 读取和序列化各占一半
+    progress_->setValue(int((read_cells_ + serialized_cells_) * 500 / total_cells_));
+}
+
+void xTableClipboardCopy::finish(bool copied) {
+    if (done_) return;
+    done_ = true;
+    cancelled_->store(!copied);
+    read_timer_->stop();
+    for (const QMetaObject::Connection &connection : std::as_const(model_connections_)) {
+        disconnect(connection);
+    }
+    if (copied) QApplication::clipboard()->setMimeData(joinChunks(chunks_));
+    chunks_.clear();
+    if (progress_) progress_->close();
+    emit finished(copied);
+    deleteLater();
+}
@@ -0,0 +1,116 @@
+#pragma once
+// ***************************************************************
+//  xTableClipboard   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+class QAbstractItemModel;
+class QMimeData;
+class QProgressDialog;
+class QThreadPool;
+class QTimer;
+class QWidget;
+
+// rows first..last of a selection, every one of them with the same selected columns
+// (ascending, non-overlapping [left, right] spans)
+struct xSelectionBand {
+    int first;
+    int last;
+    QVector<QPair<int, int>> columns;
+};
+
+// one serialized run of rows in each clipboard format
+struct xTableCopyText {
+    QString tsv;
+    QString csv;
+    QString html;
+};
+
+// Copies selected cells to the clipboard as text/plain (TSV), text/csv and an HTML table in
+// one QMimeData. Cell texts are read on the GUI thread a chunk of rows per event-loop turn
+// (the model is not thread-safe) and each chunk is serialized on a worker, so copying
+// millions of cells keeps the UI live behind a cancellable progress dialog. Cells are read
+// live, not from a snapshot: a cell edited while the copy runs is copied with its new value
+// if its row had not been read yet, so the result can mix values from different moments.
+// Rows inserted into or removed from the model shift the rows not read yet (a removed one
+// is left out); a reset, relayout or column change cancels the copy. Give it the source
+// model, not a proxy, so a re-sort or refilter of the view does not matter. The object
+// deletes itself once finished.
+class xTableClipboardCopy : public QObject {
+    Q_OBJECT
+    // rows inserted (count > 0) or removed (count < 0) starting at first
+    struct RowShift {
+        int first;
+        int count;
+    };
+
+    QPointer<QAbstractItemModel> model_;
+    // bands_[band_..] not reached yet, in row numbers as of start(); shifts_ holds the row
+    // changes since then and is replayed onto each band when it is reached, so a change costs
+    // O(1) however many bands a sorted selection was split into
+    QVector<xSelectionBand> bands_;
+    int band_ = 0;
+    QVector<RowShift> shifts_;
+    QVector<xSelectionBand> current_;  // pieces of the band being read, current row numbers
+    int max_row_ = -1;  // bound on the rows not read yet; changes past it change nothing
+    qint64 total_cells_ = 0;
+    qint64 read_cells_ = 0;
+    qint64 serialized_cells_ = 0;
+    QVector<xTableCopyText> chunks_;  // results in row order, filled as workers finish
+    int chunks_pending_ = 0;
+    bool done_ = false;
+    std::shared_ptr<std::atomic_bool> cancelled_;
+    QThreadPool *pool_ = nullptr;
+    QTimer *read_timer_ = nullptr;
+    QPointer<QProgressDialog> progress_;
+    QList<QMetaObject::Connection> model_connections_;
+
+  public:
+    // progress is shown over dialogParent when the copy takes noticeable time
+    xTableClipboardCopy(QAbstractItemModel *model, QVector<xSelectionBand> bands,
+                        QWidget *dialogParent);
+
+    ~xTableClipboardCopy() override;
+
+    static qint64 cellCount(const QVector<xSelectionBand> &bands);
+
+    // read and serialize on the calling thread; for small selections
+    static QMimeData *mimeData(const QAbstractItemModel *model,
+                               const QVector<xSelectionBand> &bands);
+
+    void start();
+
+    // leave the clipboard untouched
+    void cancel();
+
+  signals:
+    void finished(bool copied);
+
+  private:
+    void readChunk();
+
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+
+    bool hasUnread() const { return !current_.isEmpty() || band_ < bands_.size(); }
+
+    void onChunkSerialized(int chunk, const xTableCopyText &text, qint64 cells);
+
+    void updateProgress();
+
+    void finish(bool copied);
+};
@@ -9,6 +9,7 @@
 // 
 // ***************************************************************
 #include "xTableHeader.h"
+#include <QTimer>
 
 xCheckableHeaderView::xCheckableHeaderView(Qt::Orientation orientation, QWidget *parent)
     : QHeaderView(orientation, parent) {
@@ -35,6 +36,33 @@ void xCheckableHeaderView::setCheckState(int column, Qt::CheckState state) {
     }
 }
 
+void xCheckableHeaderView::setBusySection(int logicalIndex) {
+    if (busy_section_ == logicalIndex) return;
+    const int previous = busy_section_;
+    busy_section_ = logicalIndex;
+    if (previous >= 0) updateSection(previous);
+    if (logicalIndex < 0) {
+        if (busy_timer_) busy_timer_->stop();
+        return;
+    }
+    if (!busy_timer_) {
+        busy_timer_ = new QTimer(this);
+        busy_timer_->setInterval(80);
+        connect(busy_timer_, &QTimer::timeout, this, [this]() {
+            busy_angle_ = (busy_angle_ + 30) % 360;
+            if (busy_section_ >= 0) updateSection(busy_section_);
+        });
+    }
+    busy_timer_->start();
+    updateSection(logicalIndex);
+}
+
+void xCheckableHeaderView::setSortColumns(const QVector<QPair<int, Qt::SortOrder>> &columns) {
+    if (sort_columns_ == columns) return;
+    sort_columns_ = columns;
+    viewport()->update();
+}
+
 void xCheckableHeaderView::paintSection(QPainter *painter, const QRect &rect,
                                         int logicalIndex) const {
     painter->save();
@@ -42,6 +70,38 @@ void xCheckableHeaderView::paintSection(QPainter *painter, const QRect &rect,
     QHeaderView::paintSection(painter, rect, logicalIndex);
     painter->restore();
 
+    if (sort_columns_.size() > 1) {
+        // 多列排序：在排序箭头左侧标出优先级，次要列再画出各自的方向
+        for (int i = 0; i < sort_columns_.size(); ++i) {
+            if (sort_columns_.at(i).first != logicalIndex) continue;
+            QString label = QString::number(i + 1);
+            if (i > 0) {
+                label += sort_columns_.at(i).second == Qt::AscendingOrder ? QChar(0x25B2)
+                                                                           : QChar(0x25BC);
+            }
+            QFont font = painter->font();
+            font.setPointSizeF(font.pointSizeF() * 0.75);
+            painter->save();
+            painter->setFont(font);
+            painter->setPen(palette().color(QPalette::PlaceholderText));
+            painter->drawText(rect.adjusted(0, 0, -18, 0), Qt::AlignRight | Qt::AlignTop, label);
+            painter->restore();
+            break;
+        }
+    }
+
+    if (logicalIndex == busy_section_) {
+        // 忙碌指示：在排序箭头左侧画一段旋转的圆弧
+        const int size = qMin(12, rect.height() - 8);
+        QRect arcRect(rect.right() - size - 20, rect.top() + (rect.height() - size) / 2, size,
+                      size);
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(QPen(palette().color(QPalette::Highlight), 2));
+        painter->drawArc(arcRect, -busy_angle_ * 16, 270 * 16);
+        painter->restore();
+    }
+
     // 如果当前列不是布尔列，直接返回
     if (!bool_columns_.contains(logicalIndex)) {
         return;
@@ -15,6 +15,8 @@
 #include <QSet>
 #include <QMap>
 
+class QTimer;
+
 class xCheckableHeaderView : public QHeaderView {
     Q_OBJECT
     // store which columns are boolean columns
@@ -23,6 +25,14 @@ class xCheckableHeaderView : public QHeaderView {
     // store the check status of every boolean column
     QMap<int, Qt::CheckState> check_states_;
 
+    // section showing the busy spinner (-1 for none), e.g. while a background sort runs
+    int busy_section_ = -1;
+    int busy_angle_ = 0;
+    QTimer *busy_timer_ = nullptr;
+
+    // multi-column sort stack, most significant first; priorities are painted when it has 2+
+    QVector<QPair<int, Qt::SortOrder>> sort_columns_;
+
 public:
     explicit xCheckableHeaderView(Qt::Orientation orientation, QWidget *parent = nullptr);
 
@@ -30,6 +40,12 @@ public:
 
     void setCheckState(int column, Qt::CheckState state);
 
+    void setBusySection(int logicalIndex);
+
+    int busySection() const { return busy_section_; }
+
+    void setSortColumns(const QVector<QPair<int, Qt::SortOrder>> &columns);
+
   signals:
 
     void checkboxToggled(int column, Qt::CheckState newState);
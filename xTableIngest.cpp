@@ -0,0 +1,202 @@
+// ***************************************************************
+//  xTableIngest   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableIngest.h"
+#include "xTableView.h"
+#include <QElapsedTimer>
+
+struct xTableIngestOp {
+    enum Kind : quint8 { AppendRow, UpsertRow, SetCell };
+    Kind kind = AppendRow;
+    int row = 0;
+    int column = 0;  // SetCell: target column, UpsertRow: key column
+    QVariant value;
+    QVariantList values;
+    xTableIngestOp *next = nullptr;
+};
+
+xTableIngestQueue::xTableIngestQueue(xAbstractTableModel *model, QObject *parent)
+    : QObject(parent), model_(model), frame_timer_(new QTimer(this)) {
+    frame_timer_->setSingleShot(true);
+    frame_timer_->setInterval(16);
+    connect(frame_timer_, &QTimer::timeout, this, &xTableIngestQueue::onFrame);
+}
+
+xTableIngestQueue::~xTableIngestQueue() {
+    collectIncoming();
+    while (backlog_head_) {
+        xTableIngestOp *op = backlog_head_;
+        backlog_head_ = op->next;
+        delete op;
+    }
+}
+
+bool xTableIngestQueue::appendRow(const QVariantList &values) {
+    auto *op = new xTableIngestOp;
+    op->kind = xTableIngestOp::AppendRow;
+    op->values = values;
+    return push(op);
+}
+
+bool xTableIngestQueue::upsertRow(int keyColumn, const QVariantList &values) {
+    auto *op = new xTableIngestOp;
+    op->kind = xTableIngestOp::UpsertRow;
+    op->column = keyColumn;
+    op->values = values;
+    return push(op);
+}
+
+bool xTableIngestQueue::setCell(int row, int column, const QVariant &value) {
+    auto *op = new xTableIngestOp;
+    op->kind = xTableIngestOp::SetCell;
+    op->row = row;
+    op->column = column;
+    op->value = value;
+    return push(op);
+}
+
+void xTableIngestQueue::setFrameInterval(int msecs) {
+    frame_timer_->setInterval(qMax(msecs, 0));
+}
+
+void xTableIngestQueue::setFrameBudget(int maxOperations, int maxMilliseconds) {
+    max_frame_ops_ = qMax(maxOperations, 0);
+    max_frame_msecs_ = qMax(maxMilliseconds, 0);
+}
+
+void xTableIngestQueue::setMaxPending(int maxPending) {
+    max_pending_.store(qMax(maxPending, 0), std::memory_order_relaxed);
+}
+
+xTableIngestStats xTableIngestQueue::stats() const {
+    xTableIngestStats stats = stats_;
+    stats.pushed = pushed_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.pending = pending();
+    return stats;
+}
+
+void xTableIngestQueue::resetStats() {
+    stats_ = xTableIngestStats();
+    pushed_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+}
+
+void xTableIngestQueue::flush() {
+    frame_timer_->stop();
+    collectIncoming();
+    const int applied = applyBacklog(0, 0);
+    emit frameApplied(applied, pending());
+}
+
+bool xTableIngestQueue::push(xTableIngestOp *op) {
+    const int limit = max_pending_.load(std::memory_order_relaxed);
+    if (limit > 0 && pending_.load(std::memory_order_relaxed) >= limit) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        delete op;
+        return false;
+    }
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+
+    // 无锁压栈：生产者之间只竞争这一个指针
+    xTableIngestOp *head = incoming_.load(std::memory_order_relaxed);
+    do {
+        op->next = head;
+    } while (!incoming_.compare_exchange_weak(head, op, std::memory_order_release,
+                                              std::memory_order_relaxed));
+    // 只有栈由空变非空的那次投递事件，之后的生产者不再打扰 GUI 线程
+    if (!head) {
+        QMetaObject::invokeMethod(this, [this]() { scheduleFrame(); }, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+void xTableIngestQueue::scheduleFrame() {
+    if (!frame_timer_->isActive()) frame_timer_->start();
+}
+
+void xTableIngestQueue::onFrame() {
+    collectIncoming();
+    stats_.peak_pending = qMax(stats_.peak_pending, pending());
+
+    QElapsedTimer clock;
+    clock.start();
+    const int applied = applyBacklog(max_frame_ops_, qint64(max_frame_msecs_) * 1000000);
+    ++stats_.frames;
+    stats_.last_frame_applied = applied;
+    stats_.last_frame_usecs = clock.nsecsElapsed() / 1000;
+    emit frameApplied(applied, pending());
+
+    // 预算用完还有剩余，下一帧接着处理
+    if (backlog_head_) scheduleFrame();
+}
+
+void xTableIngestQueue::collectIncoming() {
+    xTableIngestOp *head = incoming_.exchange(nullptr, std::memory_order_acquire);
+    if (!head) return;
+    // 生产者栈是后进先出，反转后接到积压链表尾部
+    xTableIngestOp *tail = head;
+    xTableIngestOp *reversed = nullptr;
+    while (head) {
+        xTableIngestOp *next = head->next;
+        head->next = reversed;
+        reversed = head;
+        head = next;
+    }
+    if (backlog_tail_)
+        backlog_tail_->next = reversed;
+    else
+        backlog_head_ = reversed;
+    backlog_tail_ = tail;
+}
+
+int xTableIngestQueue::applyBacklog(int maxOperations, qint64 maxNsecs) {
+    xAbstractTableModel *model = model_;
+    QElapsedTimer clock;
+    clock.start();
+    int applied = 0;
+    QVector<QVariantList> appends;
+
+    if (model) model->beginBatch();
+    while (backlog_head_ && (maxOperations <= 0 || applied < maxOperations)) {
+        // 每 256 个操作看一次时钟
+        if (maxNsecs > 0 && (applied & 255) == 255 && clock.nsecsElapsed() >= maxNsecs) break;
+        xTableIngestOp *op = backlog_head_;
+        backlog_head_ = op->next;
+        if (!backlog_head_) backlog_tail_ = nullptr;
+
+        if (model) {
+            if (op->kind == xTableIngestOp::AppendRow) {
+                appends.append(std::move(op->values));
+            } else {
+                // 连续的追加攒成一次 appendRows；遇到其它操作先把它们落地，保持先后顺序
+                if (!appends.isEmpty()) {
+                    model->appendRows(appends);
+                    appends.clear();
+                }
+                if (op->kind == xTableIngestOp::UpsertRow)
+                    model->upsertRow(op->column, op->values);
+                else
+                    model->setData(model->index(op->row, op->column), op->value, Qt::EditRole);
+            }
+        }
+        delete op;
+        ++applied;
+    }
+    if (model) {
+        if (!appends.isEmpty()) model->appendRows(appends);
+        model->endBatch();
+    }
+
+    pending_.fetch_sub(applied, std::memory_order_relaxed);
+    stats_.applied += applied;
+    return applied;
+}
@@ -0,0 +1,98 @@
+#pragma once
+// ***************************************************************
+//  xTableIngest   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVariant>
+#include <atomic>
+
+class xAbstractTableModel;
+struct xTableIngestOp;
+
+struct xTableIngestStats {
+    quint64 pushed = 0;    // operations accepted from producers
+    quint64 dropped = 0;   // operations refused because the queue was full
+    quint64 applied = 0;   // operations applied to the model
+    int pending = 0;       // operations waiting right now
+    int peak_pending = 0;  // highest pending seen at the start of a frame
+    int frames = 0;
+    int last_frame_applied = 0;
+    qint64 last_frame_usecs = 0;
+};
+
+// Multi-producer ingest stage for an xAbstractTableModel. Any thread pushes row appends,
+// upserts and cell updates into a lock-free queue; the GUI thread drains it once per frame
+// into one beginBatch() / endBatch() transaction, within the configured frame budget.
+class xTableIngestQueue : public QObject {
+    Q_OBJECT
+    QPointer<xAbstractTableModel> model_;
+    std::atomic<xTableIngestOp *> incoming_{nullptr};  // newest first, pushed by producers
+    xTableIngestOp *backlog_head_ = nullptr;           // oldest first, GUI thread only
+    xTableIngestOp *backlog_tail_ = nullptr;
+    std::atomic_int pending_{0};
+    std::atomic<quint64> pushed_{0};
+    std::atomic<quint64> dropped_{0};
+    std::atomic_int max_pending_{0};  // 0 = unbounded
+    int max_frame_ops_ = 20000;
+    int max_frame_msecs_ = 8;
+    QTimer *frame_timer_ = nullptr;
+    xTableIngestStats stats_;  // GUI-side counters
+
+  public:
+    explicit xTableIngestQueue(xAbstractTableModel *model, QObject *parent = nullptr);
+
+    ~xTableIngestQueue() override;
+
+    // producers, callable from any thread; false when the operation was dropped because
+    // maxPending operations are already waiting
+    bool appendRow(const QVariantList &values);
+
+    bool upsertRow(int keyColumn, const QVariantList &values);
+
+    bool setCell(int row, int column, const QVariant &value);
+
+    int pending() const { return pending_.load(std::memory_order_relaxed); }
+
+    // GUI thread
+    void setFrameInterval(int msecs);
+
+    int frameInterval() const { return frame_timer_->interval(); }
+
+    // stop a frame after maxOperations operations or maxMilliseconds, whichever comes first;
+    // the rest waits for the next frame
+    void setFrameBudget(int maxOperations, int maxMilliseconds);
+
+    // backpressure: refuse new operations while this many are pending (0 = unbounded)
+    void setMaxPending(int maxPending);
+
+    xTableIngestStats stats() const;
+
+    void resetStats();
+
+    // apply everything queued so far, ignoring the frame budget
+    void flush();
+
+  signals:
+    void frameApplied(int applied, int remaining);
+
+  private:
+    bool push(xTableIngestOp *op);
+
+    void scheduleFrame();
+
+    void onFrame();
+
+    // move the producers' stack onto the backlog, restoring push order
+    void collectIncoming();
+
+    int applyBacklog(int maxOperations, qint64 maxNsecs);
+};
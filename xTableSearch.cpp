@@ -0,0 +1,313 @@
+// ***************************************************************
+//  xTableSearch   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableSearch.h"
+#include <QAbstractItemModel>
+#include <algorithm>
+
+// 已删除行的编号超过这个数（且超过存活行数）时整理一次倒排表
+static constexpr int kMinDeadKeys = 4096;
+
+static quint64 trigramAt(const QString &text, qsizetype i) {
+    return (quint64(text.at(i).unicode()) << 32) | (quint64(text.at(i + 1).unicode()) << 16) |
+           quint64(text.at(i + 2).unicode());
+}
+
+// 文本中出现过的三元组，去重后升序
+static QVector<quint64> trigramsOf(const QString &text) {
+    QVector<quint64> trigrams;
+    if (text.size() < 3) return trigrams;
+    trigrams.reserve(text.size() - 2);
+    for (qsizetype i = 0; i + 2 < text.size(); ++i) trigrams.append(trigramAt(text, i));
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+xTableSearchIndex::xTableSearchIndex(QObject *parent) : QObject(parent) {}
+
+void xTableSearchIndex::setModel(QAbstractItemModel *model) {
+    for (const QMetaObject::Connection &connection : std::as_const(connections_)) {
+        disconnect(connection);
+    }
+    connections_.clear();
+    model_ = model;
+    invalidate();
+    if (!model) return;
+
+    connections_ << connect(model, &QAbstractItemModel::dataChanged, this,
+                            &xTableSearchIndex::onDataChanged);
+    connections_ << connect(model, &QAbstractItemModel::rowsInserted, this,
+                            &xTableSearchIndex::onRowsInserted);
+    connections_ << connect(model, &QAbstractItemModel::rowsRemoved, this,
+                            &xTableSearchIndex::onRowsRemoved);
+    const auto changed = [this]() { invalidate(); };
+    connections_ << connect(model, &QAbstractItemModel::modelReset, this, changed);
+    connections_ << connect(model, &QAbstractItemModel::layoutChanged, this, changed);
+    connections_ << connect(model, &QAbstractItemModel::rowsMoved, this, changed);
+    connections_ << connect(model, &QAbstractItemModel::columnsInserted, this, changed);
+    connections_ << connect(model, &QAbstractItemModel::columnsRemoved, this, changed);
+    connections_ << connect(model, &QAbstractItemModel::columnsMoved, this, changed);
+    connections_ << connect(model, &QObject::destroyed, this, [this]() {
+        model_ = nullptr;
+        connections_.clear();
+        invalidate();
+    });
+}
+
+QModelIndexList xTableSearchIndex::find(const QString &text) {
+    QModelIndexList result;
+    const QString needle = text.toCaseFolded();
+    if (needle.isEmpty() || !model_) return result;
+    ensureIndex();
+    if (columns_ == 0) return result;
+
+    if (needle.size() < 3) {
+        // 不足三个字符查不了三元组，按行序直接扫描已折叠的文本（仍然不调用 data()）
+        for (int row = 0; row < row_keys_.size(); ++row) {
+            for (int column = 0; column < columns_; ++column) {
+                if (cells_.at(qsizetype(cellId(row, column))).contains(needle)) {
+                    result.append(model_->index(row, column));
+                }
+            }
+        }
+        return result;
+    }
+
+    // 从最短的倒排表开始求交集，候选集合只会越来越小
+    QVector<const QVector<quint64> *> lists;
+    for (quint64 trigram : trigramsOf(needle)) {
+        auto it = postings_.constFind(trigram);
+        if (it == postings_.constEnd()) return result;
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<quint64> *a, const QVector<quint64> *b) {
+                  return a->size() < b->size();
+              });
+    QVector<quint64> candidates = *lists.first();
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        QVector<quint64> merged;
+        std::set_intersection(candidates.cbegin(), candidates.cend(), lists.at(i)->cbegin(),
+                              lists.at(i)->cend(), std::back_inserter(merged));
+        candidates.swap(merged);
+    }
+
+    // 三元组全部命中不代表它们连在一起，最后用原文确认一遍；已删除的行跳过。
+    // 编号与行序无关，换成行号后重新排成行优先
+    ensureKeyRows();
+    QVector<QPair<int, int>> hits;
+    for (quint64 id : std::as_const(candidates)) {
+        const qint64 stored = key_rows_.at(qsizetype(id / quint64(columns_)));
+        if (stored < 0 || !cells_.at(qsizetype(id)).contains(needle)) continue;
+        hits.append(qMakePair(int(stored + row_offset_), int(id % quint64(columns_))));
+    }
+    std::sort(hits.begin(), hits.end());
+    result.reserve(hits.size());
+    for (const QPair<int, int> &hit : std::as_const(hits)) {
+        result.append(model_->index(hit.first, hit.second));
+    }
+    return result;
+}
+
+bool xTableSearchIndex::cellContains(int row, int column, const QString &text) {
+    const QString needle = text.toCaseFolded();
+    if (needle.isEmpty() || !model_) return false;
+    ensureIndex();
+    if (row < 0 || row >= row_keys_.size() || column < 0 || column >= columns_) return false;
+    return cells_.at(qsizetype(cellId(row, column))).contains(needle);
+}
+
+void xTableSearchIndex::invalidate() {
+    dirty_ = true;
+    columns_ = 0;
+    row_keys_.clear();
+    key_rows_.clear();
+    row_offset_ = 0;
+    key_rows_valid_ = true;
+    dead_keys_ = 0;
+    cells_.clear();
+    postings_.clear();
+    ++version_;
+}
+
+void xTableSearchIndex::ensureIndex() {
+    if (!dirty_ || !model_) return;
+    dirty_ = false;
+    const int rows = model_->rowCount();
+    columns_ = model_->columnCount();
+    row_keys_.resize(rows);
+    key_rows_.resize(rows);
+    for (int row = 0; row < rows; ++row) {
+        row_keys_[row] = quint32(row);
+        key_rows_[row] = row;
+    }
+    cells_.resize(qsizetype(rows) * columns_);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns_; ++column) {
+            const quint64 id = cellId(row, column);
+            cells_[qsizetype(id)] = cellText(row, column);
+            addCell(id);
+        }
+    }
+}
+
+void xTableSearchIndex::ensureKeyRows() {
+    if (key_rows_valid_) return;
+    key_rows_valid_ = true;
+    row_offset_ = 0;
+    key_rows_.fill(-1);
+    for (int row = 0; row < row_keys_.size(); ++row) key_rows_[row_keys_.at(row)] = row;
+}
+
+void xTableSearchIndex::compact() {
+    ensureKeyRows();
+    const int rows = row_keys_.size();
+    // 存活的行按当前行号重新编号，单元格文本随之搬动
+    QVector<QString> cells(qsizetype(rows) * columns_);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns_; ++column) {
+            cells[qsizetype(row) * columns_ + column] =
+                std::move(cells_[qsizetype(cellId(row, column))]);
+        }
+    }
+    for (auto it = postings_.begin(); it != postings_.end();) {
+        QVector<quint64> &list = it.value();
+        qsizetype kept = 0;
+        for (qsizetype i = 0; i < list.size(); ++i) {
+            const quint64 id = list.at(i);
+            const qint64 stored = key_rows_.at(qsizetype(id / quint64(columns_)));
+            if (stored < 0) continue;
+            list[kept++] =
+                quint64(stored + row_offset_) * quint64(columns_) + id % quint64(columns_);
+        }
+        list.resize(kept);
+        if (list.isEmpty()) {
+            it = postings_.erase(it);
+            continue;
+        }
+        std::sort(list.begin(), list.end());
+        ++it;
+    }
+    cells_.swap(cells);
+    key_rows_.resize(rows);
+    for (int row = 0; row < rows; ++row) {
+        row_keys_[row] = quint32(row);
+        key_rows_[row] = row;
+    }
+    row_offset_ = 0;
+    dead_keys_ = 0;
+}
+
+QString xTableSearchIndex::cellText(int row, int column) const {
+    return model_->data(model_->index(row, column), Qt::DisplayRole).toString().toCaseFolded();
+}
+
+void xTableSearchIndex::addCell(quint64 id) {
+    for (quint64 trigram : trigramsOf(cells_.at(qsizetype(id)))) {
+        QVector<quint64> &list = postings_[trigram];
+        // 整表构建和插入新行时 id 递增，直接追加即可
+        if (list.isEmpty() || list.last() < id) {
+            list.append(id);
+            continue;
+        }
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (*it != id) list.insert(it, id);
+    }
+}
+
+void xTableSearchIndex::removeCell(quint64 id) {
+    for (quint64 trigram : trigramsOf(cells_.at(qsizetype(id)))) {
+        auto posting = postings_.find(trigram);
+        if (posting == postings_.end()) continue;
+        QVector<quint64> &list = posting.value();
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (it != list.end() && *it == id) list.erase(it);
+        if (list.isEmpty()) postings_.erase(posting);
+    }
+}
+
+void xTableSearchIndex::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                      const QList<int> &roles) {
+    if (dirty_ || topLeft.parent().isValid()) return;
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole) && !roles.contains(Qt::EditRole)) {
+        return;
+    }
+    const int lastRow = qMin(bottomRight.row(), int(row_keys_.size()) - 1);
+    const int lastColumn = qMin(bottomRight.column(), columns_ - 1);
+    for (int row = topLeft.row(); row <= lastRow; ++row) {
+        for (int column = topLeft.column(); column <= lastColumn; ++column) {
+            const quint64 id = cellId(row, column);
+            QString text = cellText(row, column);
+            if (text == cells_.at(qsizetype(id))) continue;
+            removeCell(id);
+            cells_[qsizetype(id)] = std::move(text);
+            addCell(id);
+        }
+    }
+    ++version_;
+    emit cellsChanged(topLeft, bottomRight);
+}
+
+void xTableSearchIndex::onRowsInserted(const QModelIndex &parent, int first, int last) {
+    if (dirty_ || parent.isValid()) return;
+    const int rows = row_keys_.size();
+    if (first > rows) {
+        invalidate();
+        return;
+    }
+    // 新行取新编号，排在所有已有编号之后，倒排表只在末尾追加；其余行的编号不变
+    const int count = last - first + 1;
+    const quint32 firstKey = quint32(key_rows_.size());
+    row_keys_.insert(first, count, 0);
+    for (int i = 0; i < count; ++i) row_keys_[first + i] = firstKey + quint32(i);
+    if (key_rows_valid_ && first == 0) {
+        row_offset_ += count;  // 其余行整体后移
+    } else if (first != rows) {
+        key_rows_valid_ = false;  // 插在中间，下次查询时重建
+    }
+    for (int i = 0; i < count; ++i) key_rows_.append(first + i - row_offset_);
+    cells_.resize(qsizetype(key_rows_.size()) * columns_);
+    for (int row = first; row <= last; ++row) {
+        for (int column = 0; column < columns_; ++column) {
+            const quint64 id = cellId(row, column);
+            cells_[qsizetype(id)] = cellText(row, column);
+            addCell(id);
+        }
+    }
+    ++version_;
+}
+
+void xTableSearchIndex::onRowsRemoved(const QModelIndex &parent, int first, int last) {
+    if (dirty_ || parent.isValid()) return;
+    const int rows = row_keys_.size();
+    if (last >= rows) {
+        invalidate();
+        return;
+    }
+    // 删除的行只作废编号、释放文本，倒排项留到整理时一并清掉，查询时跳过
+    const int count = last - first + 1;
+    for (int row = first; row <= last; ++row) {
+        const quint32 key = row_keys_.at(row);
+        key_rows_[key] = -1;
+        for (int column = 0; column < columns_; ++column) {
+            cells_[qsizetype(cellId(row, column))].clear();
+        }
+    }
+    row_keys_.remove(first, count);
+    if (key_rows_valid_ && first == 0) {
+        row_offset_ -= count;  // 其余行整体前移
+    } else if (last != rows - 1) {
+        key_rows_valid_ = false;
+    }
+    dead_keys_ += count;
+    if (dead_keys_ > qMax(int(row_keys_.size()), kMinDeadKeys)) compact();
+    ++version_;
+}
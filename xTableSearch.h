@@ -0,0 +1,87 @@
+#pragma once
+// ***************************************************************
+//  xTableSearch   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QModelIndex>
+
+class QAbstractItemModel;
+
+// Trigram inverted index over the case-folded display text of every cell of a flat model.
+// Built lazily on the first query, then patched from the model's own signals. Postings name
+// rows by a key fixed at insertion, so inserting or removing rows anywhere only touches
+// those rows; keys of removed rows are purged in bulk once they outnumber the live rows.
+class xTableSearchIndex : public QObject {
+    Q_OBJECT
+    QAbstractItemModel *model_ = nullptr;
+    QList<QMetaObject::Connection> connections_;
+    int columns_ = 0;
+    QVector<quint32> row_keys_;  // row -> key
+    // key -> row - row_offset_, -1 once removed; inserts and removals at either end keep it
+    // current, others mark it for a rebuild on the next query
+    QVector<qint64> key_rows_;
+    qint64 row_offset_ = 0;
+    bool key_rows_valid_ = true;
+    int dead_keys_ = 0;
+    QVector<QString> cells_;                     // cell id = key * columns_ + column
+    QHash<quint64, QVector<quint64>> postings_;  // trigram -> ascending cell ids
+    bool dirty_ = true;
+    quint64 version_ = 0;
+
+  public:
+    explicit xTableSearchIndex(QObject *parent = nullptr);
+
+    void setModel(QAbstractItemModel *model);
+
+    QAbstractItemModel *model() const { return model_; }
+
+    // bumped on every change, so callers can cache query results
+    quint64 version() const { return version_; }
+
+    // cells whose display text contains text (case-insensitive), in row-major order
+    QModelIndexList find(const QString &text);
+
+    // whether the cell's display text contains text (case-insensitive)
+    bool cellContains(int row, int column, const QString &text);
+
+  signals:
+    // cell texts in the rectangle were re-read; version() was bumped by exactly one
+    void cellsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+  private:
+    void invalidate();
+
+    void ensureIndex();
+
+    void ensureKeyRows();
+
+    // renumber live rows 0..n-1 and drop the postings of removed rows
+    void compact();
+
+    quint64 cellId(int row, int column) const {
+        return quint64(row_keys_.at(row)) * quint64(columns_) + quint64(column);
+    }
+
+    QString cellText(int row, int column) const;
+
+    void addCell(quint64 id);
+
+    void removeCell(quint64 id);
+
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                       const QList<int> &roles);
+
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+};
@@ -0,0 +1,433 @@
+// ***************************************************************
+//  xTableSnapshot   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xTableSnapshot.h"
+#include "xTableCache.h"
+#include <QHash>
+#include <QSaveFile>
+#include <cstring>
+#include <limits>
+
+// 文件布局（小端，各段 8 字节对齐）：
+//   xSnapshotHeader | xSnapshotColumn * columns | 每列的 名称、空值位图、数据段、字典
+// 字符串列的数据段是 quint32 字典编号；字典是 dict_count + 1 个 quint64 偏移加 UTF-8 正文。
+static constexpr char kSnapshotMagic[8] = {'x', 'T', 'S', 'n', 'a', 'p', '0', '1'};
+static constexpr quint32 kSnapshotVersion = 1;
+static constexpr quint32 kColumnCompressed = 1;
+
+struct xSnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 columns;
+    quint64 rows;
+    quint64 reserved;
+};
+
+struct xSnapshotColumn {
+    quint32 type;
+    quint32 flags;
+    quint64 name_offset;
+    quint64 name_size;
+    quint64 nulls_offset;  // (rows + 63) / 64 个 quint64
+    quint64 data_offset;
+    quint64 data_size;  // 文件中的字节数（压缩后）
+    quint64 raw_size;   // 解压后的字节数
+    quint64 dict_offset;
+    quint64 dict_count;
+};
+
+static_assert(sizeof(xSnapshotHeader) == 32, "snapshot header layout");
+static_assert(sizeof(xSnapshotColumn) == 72, "snapshot column layout");
+
+static qint64 bitmapBytes(qint64 rows) {
+    return (rows + 63) / 64 * 8;
+}
+
+static bool testWordBit(const quint64 *words, int i) {
+    return (words[i >> 6] >> (i & 63)) & 1;
+}
+
+// 列里出现过的值决定列类型：全是布尔值为布尔列，全是整数为整数列，数值为浮点列，其余存文本
+static xColumnarTableModel::ColumnType inferType(const QVector<QVariant> &values) {
+    bool boolean = true;
+    bool integral = true;
+    bool numeric = true;
+    for (const QVariant &value : values) {
+        if (!value.isValid()) continue;
+        switch (value.typeId()) {
+            case QMetaType::Bool:
+                integral = numeric = false;
+                break;
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Long:
+            case QMetaType::ULong:
+            case QMetaType::LongLong:
+                boolean = false;
+                break;
+            case QMetaType::ULongLong:
+                // 超出 qint64 的无符号数存成 int64 会变成负数，只能按浮点存
+                boolean = false;
+                if (value.toULongLong() > quint64(std::numeric_limits<qint64>::max())) {
+                    integral = false;
+                }
+                break;
+            default: {
+                double number = 0;
+                boolean = integral = false;
+                if (!xTableCellValue::rangeNumber(value, number)) numeric = false;
+                break;
+            }
+        }
+        if (!boolean && !integral && !numeric) return xColumnarTableModel::StringColumn;
+    }
+    if (boolean) return xColumnarTableModel::BoolColumn;
+    if (integral) return xColumnarTableModel::Int64Column;
+    return xColumnarTableModel::DoubleColumn;
+}
+
+bool xTableSnapshot::save(const QAbstractItemModel *model, const QString &path, bool compress,
+                          QString *error) {
+    const auto fail = [&](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
+    if (!model) return fail(QStringLiteral("no model"));
+
+    int rows = model->rowCount();
+    const auto *table = qobject_cast<const xAbstractTableModel *>(model);
+    if (table && table->appendMode() && rows > 0) --rows;  // 占位行不存
+    const int columns = model->columnCount();
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return fail(file.errorString());
+    xSnapshotHeader header = {};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.columns = quint32(columns);
+    header.rows = quint64(rows);
+    QVector<xSnapshotColumn> directory(columns, xSnapshotColumn{});
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(directory.constData()),
+               directory.size() * sizeof(xSnapshotColumn));
+
+    const auto writeSection = [&](const QByteArray &bytes) {
+        const quint64 offset = quint64(file.pos());
+        file.write(bytes);
+        if (const int pad = int((8 - bytes.size() % 8) % 8)) file.write(QByteArray(pad, '\0'));
+        return offset;
+    };
+
+    QVector<QVariant> values(rows);
+    for (int column = 0; column < columns; ++column) {
+        for (int row = 0; row < rows; ++row) {
+            const QModelIndex idx = model->index(row, column);
+            QVariant value = model->data(idx, Qt::EditRole);
+            if (!value.isValid()) value = model->data(idx, Qt::DisplayRole);
+            values[row] = value;
+        }
+        xSnapshotColumn &entry = directory[column];
+        const auto type = inferType(values);
+        entry.type = quint32(type);
+
+        const QByteArray name = model->headerData(column, Qt::Horizontal).toString().toUtf8();
+        entry.name_size = quint64(name.size());
+        entry.name_offset = writeSection(name);
+
+        QByteArray nulls(bitmapBytes(rows), '\0');
+        auto *nullWords = reinterpret_cast<quint64 *>(nulls.data());
+        for (int row = 0; row < rows; ++row) {
+            if (!values.at(row).isValid()) nullWords[row >> 6] |= quint64(1) << (row & 63);
+        }
+        entry.nulls_offset = writeSection(nulls);
+
+        QByteArray raw;
+        QByteArray dictionary;
+        switch (type) {
+            case xColumnarTableModel::DoubleColumn: {
+                raw.fill('\0', qsizetype(rows) * 8);
+                auto *numbers = reinterpret_cast<double *>(raw.data());
+                for (int row = 0; row < rows; ++row) {
+                    double number = 0;
+                    if (xTableCellValue::rangeNumber(values.at(row), number)) numbers[row] = number;
+                }
+                break;
+            }
+            case xColumnarTableModel::Int64Column: {
+                raw.fill('\0', qsizetype(rows) * 8);
+                auto *integers = reinterpret_cast<qint64 *>(raw.data());
+                for (int row = 0; row < rows; ++row) integers[row] = values.at(row).toLongLong();
+                break;
+            }
+            case xColumnarTableModel::BoolColumn: {
+                raw.fill('\0', bitmapBytes(rows));
+                auto *words = reinterpret_cast<quint64 *>(raw.data());
+                for (int row = 0; row < rows; ++row) {
+                    if (values.at(row).toBool()) words[row >> 6] |= quint64(1) << (row & 63);
+                }
+                break;
+            }
+            case xColumnarTableModel::StringColumn: {
+                // 相同的文本只存一份，数据段里放编号
+                raw.fill('\0', qsizetype(rows) * 4);
+                auto *ids = reinterpret_cast<quint32 *>(raw.data());
+                QHash<QString, quint32> lookup;
+                QVector<quint64> offsets{0};
+                QByteArray blob;
+                for (int row = 0; row < rows; ++row) {
+                    const QString text = values.at(row).toString();
+                    auto it = lookup.constFind(text);
+                    if (it == lookup.constEnd()) {
+                        it = lookup.insert(text, quint32(offsets.size() - 1));
+                        blob += text.toUtf8();
+                        offsets.append(quint64(blob.size()));
+                    }
+                    ids[row] = it.value();
+                }
+                entry.dict_count = quint64(offsets.size() - 1);
+                dictionary = QByteArray(reinterpret_cast<const char *>(offsets.constData()),
+                                        offsets.size() * sizeof(quint64)) +
+                             blob;
+                break;
+            }
+        }
+
+        entry.raw_size = quint64(raw.size());
+        if (compress && !raw.isEmpty()) {
+            const QByteArray packed = qCompress(raw);
+            if (packed.size() < raw.size()) {
+                entry.flags |= kColumnCompressed;
+                raw = packed;
+            }
+        }
+        entry.data_size = quint64(raw.size());
+        entry.data_offset = writeSection(raw);
+        if (!dictionary.isEmpty()) entry.dict_offset = writeSection(dictionary);
+    }
+
+    file.seek(sizeof(header));
+    file.write(reinterpret_cast<const char *>(directory.constData()),
+               directory.size() * sizeof(xSnapshotColumn));
+    if (!file.commit()) return fail(file.errorString());
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+xSnapshotTableModel::xSnapshotTableModel(QObject *parent) : xAbstractTableModel(parent) {}
+
+bool xSnapshotTableModel::open(const QString &path, QString *error) {
+    const auto fail = [&](const QString &message) {
+        if (error) *error = message;
+        close();
+        return false;
+    };
+    close();
+
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) return fail(file_.errorString());
+    const quint64 size = quint64(file_.size());
+    if (size < sizeof(xSnapshotHeader)) return fail(QStringLiteral("not a table snapshot"));
+    const uchar *map = file_.map(0, qint64(size));
+    if (!map) return fail(file_.errorString());
+
+    const auto *header = reinterpret_cast<const xSnapshotHeader *>(map);
+    if (std::memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header->version != kSnapshotVersion) {
+        return fail(QStringLiteral("not a table snapshot"));
+    }
+    if (header->rows > quint64(std::numeric_limits<int>::max()) ||
+        sizeof(xSnapshotHeader) + quint64(header->columns) * sizeof(xSnapshotColumn) > size) {
+        return fail(QStringLiteral("corrupted table snapshot"));
+    }
+
+    // 只校验目录里的偏移都落在文件内，数据本身不读
+    const qint64 rows = qint64(header->rows);
+    const auto inside = [&](quint64 offset, quint64 bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+    const auto *directory = reinterpret_cast<const xSnapshotColumn *>(header + 1);
+    QVector<Column> columns;
+    columns.reserve(header->columns);
+    for (quint32 i = 0; i < header->columns; ++i) {
+        const xSnapshotColumn &entry = directory[i];
+        Column column;
+        if (entry.type > xColumnarTableModel::StringColumn ||
+            !inside(entry.name_offset, entry.name_size) ||
+            !inside(entry.nulls_offset, bitmapBytes(rows)) ||
+            !inside(entry.data_offset, entry.data_size)) {
+            return fail(QStringLiteral("corrupted table snapshot"));
+        }
+        column.type = static_cast<xColumnarTableModel::ColumnType>(entry.type);
+        column.name = QString::fromUtf8(reinterpret_cast<const char *>(map + entry.name_offset),
+                                        qsizetype(entry.name_size));
+        column.nulls = reinterpret_cast<const quint64 *>(map + entry.nulls_offset);
+        column.data = reinterpret_cast<const char *>(map + entry.data_offset);
+        column.data_size = qint64(entry.data_size);
+        column.raw_size = qint64(entry.raw_size);
+        column.compressed = entry.flags & kColumnCompressed;
+
+        qint64 expected = 0;
+        switch (column.type) {
+            case xColumnarTableModel::DoubleColumn:
+            case xColumnarTableModel::Int64Column:
+                expected = rows * 8;
+                break;
+            case xColumnarTableModel::BoolColumn:
+                expected = bitmapBytes(rows);
+                break;
+            case xColumnarTableModel::StringColumn:
+                expected = rows * 4;
+                break;
+        }
+        if (column.raw_size != expected || (!column.compressed && column.data_size != expected)) {
+            return fail(QStringLiteral("corrupted table snapshot"));
+        }
+        if (column.type == xColumnarTableModel::StringColumn) {
+            const quint64 offsetBytes = (entry.dict_count + 1) * sizeof(quint64);
+            if (entry.dict_count >= size || !inside(entry.dict_offset, offsetBytes)) {
+                return fail(QStringLiteral("corrupted table snapshot"));
+            }
+            column.dict_offsets = reinterpret_cast<const quint64 *>(map + entry.dict_offset);
+            column.dict_blob = reinterpret_cast<const char *>(map + entry.dict_offset + offsetBytes);
+            column.dict_count = entry.dict_count;
+            if (!inside(entry.dict_offset + offsetBytes, column.dict_offsets[entry.dict_count])) {
+                return fail(QStringLiteral("corrupted table snapshot"));
+            }
+        }
+        columns.append(std::move(column));
+    }
+
+    beginResetModel();
+    rows_ = int(rows);
+    columns_ = std::move(columns);
+    endResetModel();
+    return true;
+}
+
+void xSnapshotTableModel::close() {
+    beginResetModel();
+    columns_.clear();
+    rows_ = 0;
+    file_.close();  // 同时解除映射
+    endResetModel();
+}
+
+bool xSnapshotTableModel::isNull(int row, int column) const {
+    return testWordBit(columns_.at(column).nulls, row);
+}
+
+xColumnSpan<double> xSnapshotTableModel::doubles(int column) const {
+    const Column &c = columns_.at(column);
+    if (c.type != xColumnarTableModel::DoubleColumn) return {};
+    return {reinterpret_cast<const double *>(columnData(c)), rows_};
+}
+
+xColumnSpan<qint64> xSnapshotTableModel::int64s(int column) const {
+    const Column &c = columns_.at(column);
+    if (c.type != xColumnarTableModel::Int64Column) return {};
+    return {reinterpret_cast<const qint64 *>(columnData(c)), rows_};
+}
+
+xColumnSpan<quint32> xSnapshotTableModel::stringIds(int column) const {
+    const Column &c = columns_.at(column);
+    if (c.type != xColumnarTableModel::StringColumn) return {};
+    return {reinterpret_cast<const quint32 *>(columnData(c)), rows_};
+}
+
+QString xSnapshotTableModel::string(int column, quint32 id) const {
+    const Column &c = columns_.at(column);
+    if (id >= c.dict_count) return {};
+    if (c.strings.isEmpty()) {
+        // 首次解码时检查整张字典：偏移须单调不减，且不超出正文（正文末尾 open() 已查过）
+        for (quint64 i = 0; i < c.dict_count && !c.dict_corrupt; ++i) {
+            c.dict_corrupt = c.dict_offsets[i] > c.dict_offsets[i + 1];
+        }
+        c.strings.resize(qsizetype(c.dict_count));
+    }
+    if (c.dict_corrupt) return {};
+    QString &text = c.strings[id];
+    if (text.isNull()) {
+        const quint64 begin = c.dict_offsets[id];
+        text = QString::fromUtf8(c.dict_blob + begin, qsizetype(c.dict_offsets[id + 1] - begin));
+    }
+    return text;
+}
+
+int xSnapshotTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : columns_.size();
+}
+
+QVariant xSnapshotTableModel::headerData(int section, Qt::Orientation orientation,
+                                         int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 &&
+        section < columns_.size() && !columns_.at(section).name.isEmpty()) {
+        return columns_.at(section).name;
+    }
+    return xAbstractTableModel::headerData(section, orientation, role);
+}
+
+int xSnapshotTableModel::baseRowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows_;
+}
+
+QVariant xSnapshotTableModel::baseData(const QModelIndex &index, int role) const {
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return {};
+    const int row = index.row();
+    if (row >= rows_ || index.column() >= columns_.size()) return {};
+    const Column &c = columns_.at(index.column());
+    if (testWordBit(c.nulls, row)) return {};
+    const char *data = columnData(c);
+    switch (c.type) {
+        case xColumnarTableModel::DoubleColumn:
+            return reinterpret_cast<const double *>(data)[row];
+        case xColumnarTableModel::Int64Column:
+            return qlonglong(reinterpret_cast<const qint64 *>(data)[row]);
+        case xColumnarTableModel::BoolColumn:
+            return testWordBit(reinterpret_cast<const quint64 *>(data), row);
+        case xColumnarTableModel::StringColumn:
+            return string(index.column(), reinterpret_cast<const quint32 *>(data)[row]);
+    }
+    return {};
+}
+
+Qt::ItemFlags xSnapshotTableModel::baseFlags(const QModelIndex &index) const {
+    Q_UNUSED(index);
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+bool xSnapshotTableModel::baseSetData(const QModelIndex &index, const QVariant &value,
+                                      int role) {
+    Q_UNUSED(index);
+    Q_UNUSED(value);
+    Q_UNUSED(role);
+    return false;
+}
+
+bool xSnapshotTableModel::insertNewBaseRow(int row, const QVariant &value) {
+    Q_UNUSED(row);
+    Q_UNUSED(value);
+    return false;
+}
+
+const char *xSnapshotTableModel::columnData(const Column &column) const {
+    if (!column.compressed) return column.data;
+    if (column.inflated.isEmpty() && column.raw_size > 0) {
+        // 压缩列第一次访问时解压；放进 quint64 数组保证 8 字节对齐，之后同样按指针读
+        const QByteArray raw = qUncompress(reinterpret_cast<const uchar *>(column.data),
+                                           qsizetype(column.data_size));
+        column.inflated.resize((column.raw_size + 7) / 8);
+        std::memcpy(column.inflated.data(), raw.constData(),
+                    size_t(qMin<qint64>(raw.size(), column.raw_size)));
+    }
+    return reinterpret_cast<const char *>(column.inflated.constData());
+}
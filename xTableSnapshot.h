@@ -0,0 +1,92 @@
+#pragma once
+// ***************************************************************
+//  xTableSnapshot   version:  1.0   -  date:  2026/10/16
+//  -------------------------------------------------------------
+//  Yongming Wang(wangym@gmail.com)
+//  -------------------------------------------------------------
+//  This file is a part of project libQTExt.
+//  Copyright (C) 2025 - All Rights Reserved
+// ***************************************************************
+//
+// ***************************************************************
+#include "xColumnarTableModel.h"
+#include <QFile>
+
+// Compact columnar snapshot of a table's data: one typed section per column (double, int64,
+// bool bitmap, or dictionary-encoded strings), a null bitmap, and an optional zlib block per
+// column. Sections are 8-byte aligned so a mapped file can be read in place.
+class xTableSnapshot {
+  public:
+    // write every base row of model (the append-mode placeholder row is skipped); column
+    // types are inferred from the values. compress stores each data section as a zlib
+    // block when that makes it smaller.
+    static bool save(const QAbstractItemModel *model, const QString &path, bool compress = false,
+                     QString *error = nullptr);
+};
+
+// Read-only model over a memory-mapped snapshot file. open() only checks the directory, so
+// the previous session's table shows up at once; cells are read straight from the mapping
+// (compressed columns are inflated on first access).
+class xSnapshotTableModel : public xAbstractTableModel {
+    Q_OBJECT
+    struct Column {
+        QString name;
+        xColumnarTableModel::ColumnType type = xColumnarTableModel::DoubleColumn;
+        const quint64 *nulls = nullptr;
+        const char *data = nullptr;
+        qint64 data_size = 0;
+        qint64 raw_size = 0;
+        bool compressed = false;
+        const quint64 *dict_offsets = nullptr;  // dict_count + 1 offsets into dict_blob
+        const char *dict_blob = nullptr;
+        quint64 dict_count = 0;
+        mutable QVector<quint64> inflated;  // compressed columns, filled on first access
+        mutable QVector<QString> strings;   // decoded dictionary entries
+        mutable bool dict_corrupt = false;  // offsets failed the check made on first decode
+    };
+
+    QFile file_;
+    int rows_ = 0;
+    QVector<Column> columns_;
+
+  public:
+    explicit xSnapshotTableModel(QObject *parent = nullptr);
+
+    bool open(const QString &path, QString *error = nullptr);
+
+    void close();
+
+    xColumnarTableModel::ColumnType columnType(int column) const {
+        return columns_.at(column).type;
+    }
+
+    bool isNull(int row, int column) const;
+
+    // typed views into the mapping, empty when column is of another type
+    xColumnSpan<double> doubles(int column) const;
+
+    xColumnSpan<qint64> int64s(int column) const;
+
+    xColumnSpan<quint32> stringIds(int column) const;
+
+    QString string(int column, quint32 id) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+  protected:
+    int baseRowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant baseData(const QModelIndex &index, int role) const override;
+
+    Qt::ItemFlags baseFlags(const QModelIndex &index) const override;
+
+    bool baseSetData(const QModelIndex &index, const QVariant &value, int role) override;
+
+    bool insertNewBaseRow(int row, const QVariant &value) override;
+
+  private:
+    const char *columnData(const Column &column) const;
+};
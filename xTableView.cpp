@@ -23,6 +23,8 @@
 #include "xTableEditor.h"
 #include "xTableHeader.h"
 #include "xItemDelegate.h"
+#include "xTableSearch.h"
+#include "xTableClipboard.h"
 #include <QMetaType>
 #include <QString>
 #include <cstdio>  // For snprintf
@@ -35,8 +37,15 @@
 #include <QStyleOptionButton>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QJsonDocument>
 #include <QTimer>
+#include <QThreadPool>
+#include <QtAlgorithms>
 #include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <numeric>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -127,7 +136,258 @@ QRect xTableViewBoolHeader::calculateTextRect() const {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-xTableViewSortFilter::xTableViewSortFilter(QObject *parent) : QSortFilterProxyModel(parent) {}
+// 把不含元字符的正则还原成普通文本；遇到真正的元字符返回 false
+static bool unescapeLiteral(QStringView pattern, QString &literal) {
+    static const QString special = QStringLiteral("\\^$.|?*+()[]{}");
+    literal.clear();
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        QChar ch = pattern.at(i);
+        if (ch == u'\\') {
+            if (++i >= pattern.size()) return false;
+            ch = pattern.at(i);
+            if (ch.isLetterOrNumber()) return false;  // \d、\w、\1 之类是元字符
+        } else if (special.contains(ch)) {
+            return false;
+        }
+        literal += ch;
+    }
+    return true;
+}
+
+void xTableViewFilterRule::compile() {
+    match_kind = MatchNone;
+    match_text.clear();
+    matcher = QStringMatcher();
+    const QString pattern = regex.pattern();
+    if (!regex.isValid() || pattern.isEmpty()) return;
+
+    // 结尾的 $ 前面有奇数个反斜杠时是转义后的普通字符，不是锚点
+    qsizetype backslashes = 0;
+    for (qsizetype i = pattern.size() - 2; i >= 0 && pattern.at(i) == u'\\'; --i) ++backslashes;
+    const bool anchoredStart = pattern.startsWith(u'^');
+    const bool anchoredEnd = pattern.endsWith(u'$') && backslashes % 2 == 0;
+    QStringView body(pattern);
+    if (anchoredStart) body = body.mid(1);
+    if (anchoredEnd && !body.isEmpty()) body.chop(1);
+
+    if (unescapeLiteral(body, match_text)) {
+        if (anchoredStart && anchoredEnd) {
+            match_kind = MatchExact;
+        } else if (anchoredStart) {
+            match_kind = MatchPrefix;
+        } else if (anchoredEnd) {
+            match_kind = MatchSuffix;
+        } else {
+            match_kind = MatchLiteral;
+            matcher = QStringMatcher(match_text, Qt::CaseInsensitive);
+        }
+        return;
+    }
+    match_kind = MatchRegex;
+    regex.optimize();  // 立即编译（并尽量 JIT），不要留到第一次匹配时
+}
+
+bool xTableViewFilterRule::matchesText(const QString &text) const {
+    switch (match_kind) {
+        case MatchLiteral:
+            return matcher.indexIn(text) >= 0;
+        case MatchPrefix:
+            return text.startsWith(match_text, Qt::CaseInsensitive);
+        case MatchSuffix:
+            return text.endsWith(match_text, Qt::CaseInsensitive);
+        case MatchExact:
+            return text.compare(match_text, Qt::CaseInsensitive) == 0;
+        case MatchRegex:
+            return regex.match(text).hasMatch();
+        default:
+            return true;
+    }
+}
+
+bool xTableViewFilterRule::accepts(const QVariant &data) const {
+    if (match_kind != MatchNone) {
+        if (!matchesText(data.toString())) return false;
+    }
+    if (equals.isValid()) {
+        if (data != equals) return false;
+    }
+    if (hasBounds()) {
+        double d = 0;
+        if (xTableCellValue::rangeNumber(data, d) && (d < min || d > max)) return false;
+    }
+    return true;
+}
+
+bool xTableViewFilterRule::accepts(const xTableColumnCache &cache, int row) const {
+    if (match_kind != MatchNone) {
+        if (!matchesText(cache.text(row))) return false;
+    }
+    if (equals.isValid()) {
+        if (!cache.equals(row, equals_value)) return false;
+    }
+    if (hasBounds()) {
+        // 非数值的 Other 缓存为 NaN，比较总是 false，与上面跳过边界检查的结果一致
+        if (xTableCellValue::isRanged(cache.kind(row))) {
+            double d = cache.number(row);
+            if (d < min || d > max) return false;
+        }
+    }
+    return true;
+}
+
+bool xTableViewFilterRule::narrows(const xTableViewFilterRule &previous) const {
+    // 正则变长不一定收紧（例如 "a" -> "a|b"），只认编译成文本比较、且新条件蕴含旧条件的情况
+    const QString &oldText = previous.match_text;
+    const bool literalKind = match_kind >= MatchLiteral && match_kind <= MatchExact;
+    bool textNarrows = false;
+    switch (previous.match_kind) {
+        case MatchNone:
+            textNarrows = true;
+            break;
+        case MatchLiteral:
+            textNarrows = literalKind && match_text.contains(oldText, Qt::CaseInsensitive);
+            break;
+        case MatchPrefix:
+            textNarrows = (match_kind == MatchPrefix || match_kind == MatchExact) &&
+                          match_text.startsWith(oldText, Qt::CaseInsensitive);
+            break;
+        case MatchSuffix:
+            textNarrows = (match_kind == MatchSuffix || match_kind == MatchExact) &&
+                          match_text.endsWith(oldText, Qt::CaseInsensitive);
+            break;
+        case MatchExact:
+            textNarrows = match_kind == MatchExact &&
+                          match_text.compare(oldText, Qt::CaseInsensitive) == 0;
+            break;
+        case MatchRegex:
+            textNarrows = match_kind == MatchRegex && regex.pattern() == previous.regex.pattern();
+            break;
+    }
+    if (!textNarrows) return false;
+    if (previous.equals.isValid() && equals != previous.equals) return false;
+    return min >= previous.min && max <= previous.max;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// 并行过滤任务：规则和列缓存在 GUI 线程各拷贝一份作为快照（QVector 隐式共享，拷贝只加引用计数，
+// GUI 线程之后改动缓存会自动分离），工作线程只读快照，各自写结果位图中互不重叠的字，
+// 全部完成后回到 GUI 线程一次性装入代理。
+struct xTableViewFilterJob {
+    std::atomic_bool cancelled{false};
+    std::atomic_int finished_chunks{0};
+    int chunk_count = 0;
+    int row_count = 0;
+    int placeholder_row = -1;
+    QVector<xTableViewFilterRule> rules;
+    QHash<int, xTableColumnCache> columns;
+    xTableBitmap accepted;
+    // 任务执行期间源模型的变化，装入结果前在 GUI 线程补测
+    QVector<QPair<int, int>> touched_rows;
+    int appended_from = std::numeric_limits<int>::max();
+    bool rows_moved = false;
+};
+
+// 后台排序任务：GUI 线程只拷贝各排序列的原始值（模型只能在 GUI 线程访问），
+// 工作线程据此生成排序键，排出行序和名次。
+struct xTableViewSortJob {
+    struct Change {
+        enum Kind : quint8 { Inserted, Removed, Touched };
+        Kind kind;
+        int first;
+        int last;
+    };
+    std::atomic_bool cancelled{false};
+    QVector<QPair<int, Qt::SortOrder>> columns;
+    QVector<xTableSortKeys> keys;
+    QVector<int> order;  // 快照行按名次排好
+    QVector<int> ranks;
+    // 任务执行期间源模型的行变化，按发生顺序记下，装入前补到行序上
+    QVector<Change> changes;
+    bool rows_moved = false;  // 重置或整体重排，快照行号作废
+};
+
+// 每块行数取 64 的倍数，保证不同块写到位图里的字不会重叠
+static constexpr int kParallelFilterChunkRows = 64 * 1024;
+
+static bool rowPassesRules(const QVector<xTableViewFilterRule> &rules,
+                           const QHash<int, xTableColumnCache> &columns, int row) {
+    for (const xTableViewFilterRule &fr : rules) {
+        auto it = columns.constFind(fr.column);
+        if (it == columns.constEnd() || row >= it->rowCount()) continue;
+        if (!fr.accepts(*it, row)) return false;
+    }
+    return true;
+}
+
+// 逐个检查置位的行，不满足 keep 的清掉
+template <typename Keep>
+static void retainRows(xTableBitmap &rows, Keep keep) {
+    quint64 *words = rows.words();
+    for (int w = 0; w < rows.wordCount(); ++w) {
+        quint64 bits = words[w];
+        while (bits) {
+            const int bit = qCountTrailingZeroBits(bits);
+            bits &= bits - 1;
+            if (!keep((w << 6) + bit)) words[w] &= ~(quint64(1) << bit);
+        }
+    }
+}
+
+xTableViewSortFilter::xTableViewSortFilter(QObject *parent)
+    : QSortFilterProxyModel(parent), filter_pool_(new QThreadPool(this)) {
+    // 排序设置变了，已有的排序键作废；lessThan 在重建前会退回逐个比较 data()
+    const auto resort = [this]() {
+        if (!sort_keys_.isEmpty()) rebuildSortKeys();
+    };
+    connect(this, &QSortFilterProxyModel::sortRoleChanged, this, resort);
+    connect(this, &QSortFilterProxyModel::sortCaseSensitivityChanged, this, resort);
+    connect(this, &QSortFilterProxyModel::sortLocaleAwareChanged, this, resort);
+}
+
+xTableViewSortFilter::~xTableViewSortFilter() {
+    // 工作线程会向 this 投递结果，必须在对象析构前等它们退出
+    cancelFilter();
+    if (sort_job_) sort_job_->cancelled = true;
+    filter_pool_->waitForDone();
+}
+
+void xTableViewSortFilter::setSourceModel(QAbstractItemModel *model) {
+    for (const QMetaObject::Connection &connection : std::as_const(source_connections_)) {
+        disconnect(connection);
+    }
+    source_connections_.clear();
+    cancelFilter();
+    cancelSort();
+    accepted_rows_valid_ = false;
+    table_source_ = qobject_cast<const xAbstractTableModel *>(model);
+    category_passes_.clear();
+    sort_keys_.clear();
+    sort_ranks_.clear();
+
+    // 必须先于 QSortFilterProxyModel 自己的连接建立：同一信号的槽按连接顺序调用，
+    // 这样代理在重新过滤变动行之前，列缓存已经是最新值。
+    if (model) {
+        source_connections_ << connect(model, &QAbstractItemModel::dataChanged, this,
+                                       &xTableViewSortFilter::onSourceDataChanged);
+        source_connections_ << connect(model, &QAbstractItemModel::rowsInserted, this,
+                                       &xTableViewSortFilter::onSourceRowsInserted);
+        source_connections_ << connect(model, &QAbstractItemModel::rowsRemoved, this,
+                                       &xTableViewSortFilter::onSourceRowsRemoved);
+        const auto changed = [this]() { onSourceStructureChanged(); };
+        source_connections_ << connect(model, &QAbstractItemModel::modelReset, this, changed);
+        source_connections_ << connect(model, &QAbstractItemModel::layoutChanged, this, changed);
+        source_connections_ << connect(model, &QAbstractItemModel::rowsMoved, this, changed);
+        source_connections_ << connect(model, &QAbstractItemModel::columnsInserted, this, changed);
+        source_connections_ << connect(model, &QAbstractItemModel::columnsRemoved, this, changed);
+        source_connections_ << connect(model, &QAbstractItemModel::columnsMoved, this, changed);
+    }
+    rebuildColumnCaches(model);
+    rebuildColumnIndexes(model);
+    QSortFilterProxyModel::setSourceModel(model);
+    rebuildAcceptedRows();
+    if (!sort_columns_.isEmpty()) rebuildSortKeys();
+}
 
 void xTableViewSortFilter::setColumnFilter(int column, const QVariantMap &conditions) {
     auto rule = std::find_if(filters_.begin(), filters_.end(),
@@ -140,20 +400,304 @@ void xTableViewSortFilter::setColumnFilter(int column, const QVariantMap &condit
     if (conditions.contains("equals")) fr.equals = conditions.value("equals");
     if (conditions.contains("min")) fr.min = conditions.value("min").toDouble();
     if (conditions.contains("max")) fr.max = conditions.value("max").toDouble();
+    fr.equals_value = xTableCellValue::decode(fr.equals);
+    fr.compile();
+    // 新增一列规则只会多一个与条件，必然是收紧
+    const bool narrowed = rule == filters_.end() || fr.narrows(*rule);
     if (rule != filters_.end())
         *rule = fr;
     else
         filters_.append(fr);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
-    beginFilterChange();
-    endFilterChange();
-#else
-    invalidateFilter();
-#endif
+    category_passes_.remove(column);
+    if (useColumnCache() && column >= 0 && !column_caches_.contains(column) && sourceModel() &&
+        column < sourceModel()->columnCount()) {
+        column_caches_[column].fill(sourceModel(), column, Qt::DisplayRole);
+    }
+    if (rule_bitmaps_enabled_ && accepted_rows_valid_ && !filter_job_) {
+        // 只重算这一列规则的位图，再与其余各列的位图按字相与
+        updateRuleBitmap(column, narrowed);
+        combineRuleBitmaps();
+        invalidateRowFilter();
+        return;
+    }
+    applyFilterChange(narrowed);
 }
 
 void xTableViewSortFilter::clearFilters() {
     filters_.clear();
+    column_caches_.clear();
+    rule_bitmaps_.clear();
+    category_passes_.clear();
+    applyFilterChange();
+}
+
+void xTableViewSortFilter::setRuleBitmapsEnabled(bool enabled) {
+    if (rule_bitmaps_enabled_ == enabled) return;
+    rule_bitmaps_enabled_ = enabled;
+    rule_bitmaps_.clear();
+    // 两种方式结果相同，这里只是换一种方式把接受位图重建出来
+    applyFilterChange();
+}
+
+void xTableViewSortFilter::setColumnIndexed(int column, bool indexed) {
+    if (!indexed) {
+        column_indexes_.remove(column);
+        return;
+    }
+    if (column < 0 || column_indexes_.contains(column)) return;
+    xTableColumnIndex &index = column_indexes_[column];
+    if (sourceModel() && column < sourceModel()->columnCount()) {
+        index.fill(sourceModel(), column, Qt::DisplayRole);
+    }
+    // 索引只影响求值路径，不影响结果，不需要重新过滤
+}
+
+void xTableViewSortFilter::setColumnCacheEnabled(bool enabled) {
+    if (column_cache_enabled_ == enabled) return;
+    column_cache_enabled_ = enabled;
+    // 缓存只是 data() 的镜像，开关前后过滤结果相同，不需要重新过滤
+    rebuildColumnCaches(sourceModel());
+}
+
+void xTableViewSortFilter::setParallelFilterEnabled(bool enabled, int minRows) {
+    parallel_filter_min_rows_ = qMax(minRows, 1);
+    if (parallel_filter_enabled_ == enabled) return;
+    parallel_filter_enabled_ = enabled;
+    rebuildColumnCaches(sourceModel());
+    if (!enabled && filter_job_) {
+        // 关闭时还有任务在跑，改为同步完成这次过滤，避免界面停在旧结果上
+        applyFilterChange();
+    }
+}
+
+void xTableViewSortFilter::cancelFilter() {
+    if (!filter_job_) return;
+    filter_job_->cancelled = true;
+    filter_job_.reset();
+}
+
+const xTableColumnCache *xTableViewSortFilter::cachedColumn(int column, int sourceRow) const {
+    if (column_caches_.isEmpty()) return nullptr;
+    auto it = column_caches_.constFind(column);
+    if (it == column_caches_.constEnd() || sourceRow >= it->rowCount()) return nullptr;
+    return &it.value();
+}
+
+const xTableCategoryColumn *xTableViewSortFilter::categoryColumn(int column,
+                                                                 int sourceRow) const {
+    if (!table_source_) return nullptr;
+    const xTableCategoryColumn *categories = table_source_->categoryColumn(column);
+    return categories && sourceRow < categories->rowCount() ? categories : nullptr;
+}
+
+const QVector<quint8> &xTableViewSortFilter::categoryPasses(
+    const xTableViewFilterRule &fr, const xTableCategoryColumn &categories) const {
+    // 规则对每个类别只求值一次（与逐行比较 QVariant 结果相同），之后逐行只按编码查表。
+    // 字典平时只增不减，新出现的类别补算即可；字典压缩过（generation 变了）、重置或换规则时
+    // 整张表作废。
+    CategoryPasses &cached = category_passes_[fr.column];
+    QVector<quint8> &passes = cached.passes;
+    const int count = categories.categoryCount();
+    if (cached.generation != categories.generation()) {
+        cached.generation = categories.generation();
+        passes.clear();
+    }
+    if (passes.size() != count + 1) {
+        const int known = passes.size() > count ? 0 : qMax(int(passes.size()) - 1, 0);
+        passes.resize(count + 1);
+        for (int code = known; code < count; ++code) {
+            passes[code] = fr.accepts(QVariant(categories.category(quint32(code))));
+        }
+        passes[count] = fr.accepts(QVariant());
+    }
+    return passes;
+}
+
+bool xTableViewSortFilter::categoryRulesOnly() const {
+    return !filters_.isEmpty() &&
+           std::all_of(filters_.cbegin(), filters_.cend(), [this](const xTableViewFilterRule &fr) {
+               return table_source_ && table_source_->categoryColumn(fr.column);
+           });
+}
+
+void xTableViewSortFilter::rebuildColumnCaches(const QAbstractItemModel *model) {
+    column_caches_.clear();
+    if (!useColumnCache() || !model) return;
+
+    const int columnCount = model->columnCount();
+    for (const xTableViewFilterRule &fr : std::as_const(filters_)) {
+        if (fr.column < 0 || fr.column >= columnCount || column_caches_.contains(fr.column)) {
+            continue;
+        }
+        column_caches_[fr.column].fill(model, fr.column, Qt::DisplayRole);
+    }
+}
+
+void xTableViewSortFilter::rebuildColumnIndexes(const QAbstractItemModel *model) {
+    const int columnCount = model ? model->columnCount() : 0;
+    for (auto it = column_indexes_.begin(); it != column_indexes_.end(); ++it) {
+        if (it.key() < columnCount)
+            it->fill(model, it.key(), Qt::DisplayRole);
+        else
+            it->clear();
+    }
+}
+
+bool xTableViewSortFilter::indexedRuleRows(const xTableViewFilterRule &fr,
+                                           xTableBitmap *rows) const {
+    auto it = column_indexes_.constFind(fr.column);
+    if (it == column_indexes_.constEnd() || !sourceModel() ||
+        it->rowCount() != sourceModel()->rowCount()) {
+        return false;
+    }
+    const bool equality = fr.equals.isValid() && (fr.equals_value.isNumber() ||
+                                                 fr.equals_value.kind == xTableCellValue::String);
+    // 默认边界覆盖全部数值，查索引等于把所有行都列为候选，没有意义
+    const bool bounded = fr.min > std::numeric_limits<double>::lowest() ||
+                         fr.max < std::numeric_limits<double>::max();
+    if (!equality && !bounded) return false;
+    if (!rows) return true;
+    if (equality) return it->equalRows(fr.equals_value, *rows);
+    it->rangeRows(fr.min, fr.max, *rows);
+    return true;
+}
+
+bool xTableViewSortFilter::indexedCandidates(xTableBitmap *rows) const {
+    bool found = false;
+    for (const xTableViewFilterRule &fr : filters_) {
+        if (!rows) {
+            if (indexedRuleRows(fr, nullptr)) return true;
+            continue;
+        }
+        // 每条规则给出的都是自身通过行的超集，相与后仍是整体通过行的超集
+        xTableBitmap ruleRows;
+        if (!indexedRuleRows(fr, &ruleRows)) continue;
+        if (found)
+            *rows &= ruleRows;
+        else
+            *rows = ruleRows;
+        found = true;
+    }
+    if (found && isPlaceholderRow(rows->size() - 1)) rows->setBit(rows->size() - 1);
+    return found;
+}
+
+void xTableViewSortFilter::applyFilterChange(bool narrowed) {
+    if (narrowed && accepted_rows_valid_ && !filter_job_) {
+        // 规则只收紧时，原来被拒绝的行不可能重新通过，只需重测当前接受的行；
+        // 代理随后的整表刷新只读位图，不再逐行求值
+        narrowAcceptedRows();
+        invalidateRowFilter();
+        return;
+    }
+    accepted_rows_valid_ = false;
+    // 有序索引能排除大部分行时，同步复核候选行比多线程扫整表更快；
+    // 规则全在分类列上时逐行只查编码，也不值得分给工作线程
+    if (parallel_filter_enabled_ && !rule_bitmaps_enabled_ && !filters_.isEmpty() &&
+        sourceModel() && sourceModel()->rowCount() >= parallel_filter_min_rows_ &&
+        !indexedCandidates(nullptr) && !categoryRulesOnly()) {
+        startParallelFilter();
+        return;
+    }
+    cancelFilter();
+    rebuildAcceptedRows();
+    invalidateRowFilter();
+}
+
+void xTableViewSortFilter::rebuildAcceptedRows() {
+    accepted_rows_valid_ = false;
+    rule_bitmaps_.clear();
+    // 没有规则时每行都接受，不维护位图
+    if (filters_.isEmpty() || !sourceModel()) return;
+
+    if (rule_bitmaps_enabled_) {
+        for (const xTableViewFilterRule &fr : std::as_const(filters_)) {
+            updateRuleBitmap(fr.column, false);
+        }
+        combineRuleBitmaps();
+        return;
+    }
+
+    const QModelIndex root;
+    const int rowCount = sourceModel()->rowCount();
+    if (indexedCandidates(&accepted_rows_)) {
+        // 有序索引已经二分出候选行，只复核这些行
+        retainRows(accepted_rows_, [&](int row) { return testRow(row, root); });
+        accepted_rows_valid_ = true;
+        return;
+    }
+    accepted_rows_ = xTableBitmap(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        if (testRow(row, root)) accepted_rows_.setBit(row);
+    }
+    accepted_rows_valid_ = true;
+}
+
+void xTableViewSortFilter::narrowAcceptedRows() {
+    const QModelIndex root;
+    xTableBitmap candidates;
+    if (indexedCandidates(&candidates)) accepted_rows_ &= candidates;
+    retainRows(accepted_rows_, [&](int row) { return testRow(row, root); });
+}
+
+void xTableViewSortFilter::updateRuleBitmap(int column, bool narrowed) {
+    auto rule = std::find_if(filters_.cbegin(), filters_.cend(),
+                             [&](const xTableViewFilterRule &r) { return r.column == column; });
+    if (rule == filters_.cend()) return;
+    const int rowCount = sourceModel()->rowCount();
+
+    const auto passes = [&](int row) { return testRule(*rule, row); };
+    auto bitmap = rule_bitmaps_.find(column);
+    if (narrowed && bitmap != rule_bitmaps_.end() && bitmap->size() == rowCount) {
+        // 规则只收紧：只重测这一列原来通过的行
+        retainRows(*bitmap, passes);
+        return;
+    }
+
+    xTableBitmap accepted;
+    if (indexedRuleRows(*rule, &accepted)) {
+        retainRows(accepted, passes);
+        rule_bitmaps_.insert(column, accepted);
+        return;
+    }
+    accepted = xTableBitmap(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        if (testRule(*rule, row)) accepted.setBit(row);
+    }
+    rule_bitmaps_.insert(column, accepted);
+}
+
+void xTableViewSortFilter::combineRuleBitmaps() {
+    const int rowCount = sourceModel()->rowCount();
+    accepted_rows_ = xTableBitmap(rowCount, true);
+    for (const xTableBitmap &bitmap : std::as_const(rule_bitmaps_)) accepted_rows_ &= bitmap;
+    if (isPlaceholderRow(rowCount - 1)) accepted_rows_.setBit(rowCount - 1);
+    accepted_rows_valid_ = true;
+}
+
+void xTableViewSortFilter::retestRows(int first, int last) {
+    const QModelIndex root;
+    first = qMax(first, 0);
+    last = qMin(last, accepted_rows_.size() - 1);
+    for (int row = first; row <= last; ++row) {
+        if (!rule_bitmaps_enabled_) {
+            accepted_rows_.setBit(row, testRow(row, root));
+            continue;
+        }
+        // 各列位图与接受位图一起更新，保持“接受 = 各列相与”
+        bool accepted = true;
+        for (const xTableViewFilterRule &fr : std::as_const(filters_)) {
+            auto bitmap = rule_bitmaps_.find(fr.column);
+            if (bitmap == rule_bitmaps_.end() || row >= bitmap->size()) continue;
+            const bool passed = testRule(fr, row);
+            bitmap->setBit(row, passed);
+            accepted = accepted && passed;
+        }
+        accepted_rows_.setBit(row, accepted || isPlaceholderRow(row));
+    }
+}
+
+void xTableViewSortFilter::invalidateRowFilter() {
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     endFilterChange();
@@ -162,65 +706,455 @@ void xTableViewSortFilter::clearFilters() {
 #endif
 }
 
-bool xTableViewSortFilter::lessThan(const QModelIndex &source_left,
-                                    const QModelIndex &source_right) const {
-    // 首先，获取源模型，并检查是否开启了追加模式
-    auto source_model = qobject_cast<const xAbstractTableModel *>(sourceModel());
-    if (!source_model || !source_model->appendMode()) {
-        // 如果没有源模型或未开启追加模式，则使用默认的比较逻辑
-        return QSortFilterProxyModel::lessThan(source_left, source_right);
+void xTableViewSortFilter::startParallelFilter() {
+    cancelFilter();
+
+    const QAbstractItemModel *model = sourceModel();
+    auto job = std::make_shared<xTableViewFilterJob>();
+    job->rules = filters_;  // 规则在 setColumnFilter 时已编译，工作线程共享同一份结果
+    job->columns = column_caches_;
+    job->row_count = model->rowCount();
+    job->placeholder_row =
+        table_source_ && table_source_->appendMode() ? table_source_->baseRowCount() : -1;
+    job->accepted = xTableBitmap(job->row_count);
+    job->chunk_count = (job->row_count + kParallelFilterChunkRows - 1) / kParallelFilterChunkRows;
+    filter_job_ = job;
+
+    if (job->chunk_count == 0) {
+        onFilterChunkFinished(job, 0);
+        return;
+    }
+
+    quint64 *words = job->accepted.words();
+    for (int first = 0; first < job->row_count; first += kParallelFilterChunkRows) {
+        const int last = qMin(first + kParallelFilterChunkRows, job->row_count) - 1;
+        filter_pool_->start([this, job, words, first, last]() {
+            for (int row = first; row <= last; ++row) {
+                if ((row & 1023) == 0 && job->cancelled.load(std::memory_order_relaxed)) return;
+                if (row == job->placeholder_row || rowPassesRules(job->rules, job->columns, row)) {
+                    words[row >> 6] |= quint64(1) << (row & 63);
+                }
+            }
+            const int finished = ++job->finished_chunks;
+            QMetaObject::invokeMethod(
+                this, [this, job, finished]() { onFilterChunkFinished(job, finished); },
+                Qt::QueuedConnection);
+        });
+    }
+}
+
+void xTableViewSortFilter::onFilterChunkFinished(const std::shared_ptr<xTableViewFilterJob> &job,
+                                                 int finished) {
+    if (job != filter_job_) return;  // 已被更新的过滤取消
+
+    emit filterProgress(qMin(finished * kParallelFilterChunkRows, job->row_count), job->row_count);
+    if (finished < job->chunk_count) return;
+
+    if (job->rows_moved) {
+        // 任务期间有中间插入、删除或重置，快照行号已失效，按当前数据重来一遍
+        startParallelFilter();
+        return;
+    }
+    filter_job_.reset();
+
+    const QModelIndex root;
+    const int rowCount = sourceModel()->rowCount();
+    accepted_rows_ = job->accepted;
+    // 追加模式下新行插在占位行之前，所以从最早的追加位置起整段重测
+    const int appendedFrom = qMin(job->appended_from, accepted_rows_.size());
+    accepted_rows_.resize(rowCount);
+    for (int row = appendedFrom; row < rowCount; ++row) {
+        accepted_rows_.setBit(row, testRow(row, root));
+    }
+    for (const QPair<int, int> &range : std::as_const(job->touched_rows)) {
+        for (int row = range.first; row <= range.second && row < rowCount; ++row) {
+            accepted_rows_.setBit(row, testRow(row, root));
+        }
+    }
+    accepted_rows_valid_ = true;
+    invalidateRowFilter();
+    emit filterFinished();
+}
+
+void xTableViewSortFilter::onSourceDataChanged(const QModelIndex &topLeft,
+                                               const QModelIndex &bottomRight,
+                                               const QList<int> &roles) {
+    if (topLeft.parent().isValid()) return;
+    // 只改了颜色、字体之类的角色时显示值不变；EditRole 改动通常也会改变 DisplayRole
+    const bool valueChanged =
+        roles.isEmpty() || roles.contains(Qt::DisplayRole) || roles.contains(Qt::EditRole);
+    const bool sortValueChanged = valueChanged || roles.contains(sortRole());
+    const auto inRange = [&](int column) {
+        return column >= topLeft.column() && column <= bottomRight.column();
+    };
+    if (sortValueChanged) {
+        for (xTableSortKeys &keys : sort_keys_) {
+            if (!inRange(keys.column())) continue;
+            // 名次无法局部修补，清掉后 lessThan 直接比较排序键
+            keys.update(sourceModel(), topLeft.row(), bottomRight.row());
+            sort_ranks_.clear();
+        }
+        if (sort_job_ && std::any_of(sort_job_->columns.cbegin(), sort_job_->columns.cend(),
+                                     [&](const QPair<int, Qt::SortOrder> &entry) {
+                                         return inRange(entry.first);
+                                     })) {
+            sort_job_->changes.append(
+                {xTableViewSortJob::Change::Touched, topLeft.row(), bottomRight.row()});
+        }
+    }
+    if (!valueChanged) return;
+    if (filter_job_) filter_job_->touched_rows.append(qMakePair(topLeft.row(), bottomRight.row()));
+    for (auto it = column_caches_.begin(); it != column_caches_.end(); ++it) {
+        if (it.key() >= topLeft.column() && it.key() <= bottomRight.column()) {
+            it->update(sourceModel(), it.key(), Qt::DisplayRole, topLeft.row(),
+                       bottomRight.row());
+        }
     }
+    for (xTableColumnIndex &index : column_indexes_) {
+        if (inRange(index.column())) index.update(sourceModel(), topLeft.row(), bottomRight.row());
+    }
+    // 代理紧接着会对这些行调用 filterAcceptsRow，届时读到的已是新结果
+    if (accepted_rows_valid_) retestRows(topLeft.row(), bottomRight.row());
+}
+
+void xTableViewSortFilter::onSourceRowsInserted(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) return;
+    if (filter_job_) {
+        // 末尾追加（含追加模式下插在占位行之前）只需补测新行，其余插入会打乱快照行号
+        const int tail = filter_job_->row_count - (filter_job_->placeholder_row >= 0 ? 1 : 0);
+        if (first >= tail) {
+            filter_job_->appended_from = qMin(filter_job_->appended_from, first);
+        } else {
+            filter_job_->rows_moved = true;
+        }
+    }
+    for (auto it = column_caches_.begin(); it != column_caches_.end(); ++it) {
+        it->insertRows(sourceModel(), it.key(), Qt::DisplayRole, first, last);
+    }
+    for (xTableColumnIndex &index : column_indexes_) index.insertRows(sourceModel(), first, last);
+    for (xTableSortKeys &keys : sort_keys_) keys.insertRows(sourceModel(), first, last);
+    sort_ranks_.clear();
+    if (sort_job_) sort_job_->changes.append({xTableViewSortJob::Change::Inserted, first, last});
+    if (!accepted_rows_valid_) return;
+    const int count = last - first + 1;
+    if (accepted_rows_.size() != sourceModel()->rowCount() - count) {
+        rebuildAcceptedRows();  // 位图与模型已经对不上，整表重算
+        return;
+    }
+    accepted_rows_.insert(first, count);
+    for (xTableBitmap &bitmap : rule_bitmaps_) bitmap.insert(first, count);
+    retestRows(first, last);
+}
+
+void xTableViewSortFilter::onSourceRowsRemoved(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) return;
+    if (filter_job_) filter_job_->rows_moved = true;
+    for (auto it = column_caches_.begin(); it != column_caches_.end(); ++it) {
+        it->removeRows(first, last);
+    }
+    for (xTableColumnIndex &index : column_indexes_) index.removeRows(first, last);
+    for (xTableSortKeys &keys : sort_keys_) keys.removeRows(first, last);
+    sort_ranks_.clear();
+    if (sort_job_) sort_job_->changes.append({xTableViewSortJob::Change::Removed, first, last});
+    if (!accepted_rows_valid_) return;
+    accepted_rows_.remove(first, last - first + 1);
+    for (xTableBitmap &bitmap : rule_bitmaps_) bitmap.remove(first, last - first + 1);
+    if (accepted_rows_.size() != sourceModel()->rowCount()) rebuildAcceptedRows();
+}
+
+void xTableViewSortFilter::onSourceStructureChanged() {
+    category_passes_.clear();  // 重置后字典可能已经换了
+    rebuildColumnCaches(sourceModel());
+    rebuildColumnIndexes(sourceModel());
+    // 代理随后会整表重排，先把排序键和名次备好
+    if (!sort_keys_.isEmpty()) rebuildSortKeys();
+    if (sort_job_) sort_job_->rows_moved = true;
+    if (filter_job_)
+        filter_job_->rows_moved = true;
+    else
+        rebuildAcceptedRows();
+}
+
+void xTableViewSortFilter::sort(int column, Qt::SortOrder order) {
+    QVector<QPair<int, Qt::SortOrder>> columns;
+    if (column >= 0) columns.append(qMakePair(column, order));
+    sortByColumns(columns);
+}
+
+void xTableViewSortFilter::sortByColumns(const QVector<QPair<int, Qt::SortOrder>> &columns) {
+    // 用户连续点击表头时，上一次还没排完的结果直接丢弃
+    cancelSort();
+    const QAbstractItemModel *model = sourceModel();
+    sort_columns_.clear();
+    for (const QPair<int, Qt::SortOrder> &entry : columns) {
+        const bool listed =
+            std::any_of(sort_columns_.cbegin(), sort_columns_.cend(),
+                        [&](const QPair<int, Qt::SortOrder> &c) { return c.first == entry.first; });
+        if (entry.first >= 0 && (!model || entry.first < model->columnCount()) && !listed) {
+            sort_columns_.append(entry);
+        }
+    }
+    if (sort_columns_.isEmpty()) {
+        sort_keys_.clear();
+        sort_ranks_.clear();
+        QSortFilterProxyModel::sort(-1);
+        return;
+    }
+
+    if (async_sort_enabled_ && model && model->rowCount() >= async_sort_min_rows_) {
+        startAsyncSort();
+        return;
+    }
+    rebuildSortKeys();
+    QSortFilterProxyModel::sort(sort_columns_.first().first, sort_columns_.first().second);
+}
+
+void xTableViewSortFilter::setAsyncSortEnabled(bool enabled, int minRows) {
+    async_sort_min_rows_ = qMax(minRows, 1);
+    async_sort_enabled_ = enabled;
+}
+
+void xTableViewSortFilter::cancelSort() {
+    if (!sort_job_) return;
+    sort_job_->cancelled = true;
+    sort_job_.reset();
+    emit sortFinished(false);
+}
+
+// 基类按第一列的方向整体正排或倒排，所以其余各列只记录与第一列方向是否相反
+static QVector<bool> reversedSortColumns(const QVector<QPair<int, Qt::SortOrder>> &columns) {
+    QVector<bool> reversed;
+    for (const QPair<int, Qt::SortOrder> &entry : columns) {
+        reversed.append(entry.second != columns.first().second);
+    }
+    return reversed;
+}
+
+void xTableViewSortFilter::startAsyncSort() {
+    const QAbstractItemModel *model = sourceModel();
+    auto job = std::make_shared<xTableViewSortJob>();
+    job->columns = sort_columns_;
+    for (const QPair<int, Qt::SortOrder> &entry : std::as_const(job->columns)) {
+        xTableSortKeys keys;
+        keys.capture(model, entry.first, sortRole(), sortCaseSensitivity(), isSortLocaleAware());
+        job->keys.append(keys);
+    }
+    sort_job_ = job;
+    emit sortStarted(job->columns.first().first, job->columns.first().second);
+
+    filter_pool_->start([this, job]() {
+        for (xTableSortKeys &keys : job->keys) {
+            if (!keys.build(&job->cancelled)) return;
+        }
+        job->ranks = xTableSortKeys::ranks(job->keys, reversedSortColumns(job->columns),
+                                           &job->cancelled, &job->order);
+        if (job->cancelled) return;
+        QMetaObject::invokeMethod(
+            this, [this, job]() { onSortJobFinished(job); }, Qt::QueuedConnection);
+    });
+}
 
-    // 获取占位符行的真实行号
-    int placeholderRow = source_model->baseRowCount();
+void xTableViewSortFilter::onSortJobFinished(const std::shared_ptr<xTableViewSortJob> &job) {
+    if (job != sort_job_) return;  // 已被更新的排序取消
+    sort_job_.reset();
 
-    // 判断左右两个比较项是否是占位符行
-    bool leftIsPlaceholder = (source_left.row() == placeholderRow);
-    bool rightIsPlaceholder = (source_right.row() == placeholderRow);
-    if (!leftIsPlaceholder && !rightIsPlaceholder)
-        return QSortFilterProxyModel::lessThan(source_left, source_right);
+    if (job->rows_moved) {
+        // 任务期间源模型重置或整体重排，快照行号全部作废，按当前数据重排
+        startAsyncSort();
+        return;
+    }
+
+    sort_keys_ = job->keys;
+    sort_ranks_ = job->ranks;
+    if (!job->changes.isEmpty() && !patchSortRanks(*job)) rebuildSortKeys();
+    // QSortFilterProxyModel 不开放它的行映射，行序只能经由基类排序装入：只发一次
+    // layoutAboutToBeChanged / layoutChanged，lessThan 只比较两个现成的名次
+    QSortFilterProxyModel::sort(job->columns.first().first, job->columns.first().second);
+    emit sortFinished(true);
+}
+
+bool xTableViewSortFilter::patchSortRanks(const xTableViewSortJob &job) {
+    const QAbstractItemModel *model = sourceModel();
+    // 按发生顺序重放期间的行变化：origin 记当前行来自快照的哪一行（新行为 -1），
+    // dirty 标出要重新取键的当前行（新插入的和改动过的）
+    QVector<int> origin(job.ranks.size());
+    std::iota(origin.begin(), origin.end(), 0);
+    xTableBitmap dirty(origin.size());
+    for (const xTableViewSortJob::Change &change : job.changes) {
+        const int count = change.last - change.first + 1;
+        if (change.first < 0 || count <= 0) return false;
+        switch (change.kind) {
+            case xTableViewSortJob::Change::Inserted:
+                if (change.first > origin.size()) return false;
+                origin.insert(change.first, count, -1);
+                dirty.insert(change.first, count, true);
+                for (xTableSortKeys &keys : sort_keys_) keys.insertEmptyRows(change.first, count);
+                break;
+            case xTableViewSortJob::Change::Removed:
+                if (change.last >= origin.size()) return false;
+                origin.remove(change.first, count);
+                dirty.remove(change.first, count);
+                for (xTableSortKeys &keys : sort_keys_) keys.removeRows(change.first, change.last);
+                break;
+            case xTableViewSortJob::Change::Touched:
+                for (int row = change.first; row <= qMin(change.last, dirty.size() - 1); ++row) {
+                    dirty.setBit(row);
+                }
+                break;
+        }
+    }
+    if (!model || origin.size() != model->rowCount()) return false;
+
+    // 脏行按段重新取键；其余行的键没变，快照里的先后次序仍然成立
+    QVector<int> loose;
+    QVector<int> current(job.ranks.size(), -1);  // 快照行 -> 当前行，删掉或改动过的为 -1
+    for (int row = 0; row < origin.size(); ++row) {
+        if (!dirty.testBit(row)) {
+            current[origin.at(row)] = row;
+            continue;
+        }
+        if (loose.isEmpty() || loose.last() + 1 != row) {
+            int last = row;
+            while (last + 1 < origin.size() && dirty.testBit(last + 1)) ++last;
+            for (xTableSortKeys &keys : sort_keys_) keys.update(model, row, last);
+        }
+        loose.append(row);
+    }
+    const auto less = [this](int left, int right) { return sortKeysLessThan(left, right); };
+    std::stable_sort(loose.begin(), loose.end(), less);
+    QVector<int> clean;
+    clean.reserve(origin.size() - loose.size());
+    for (int row : job.order) {
+        if (current.at(row) >= 0) clean.append(current.at(row));
+    }
+    QVector<int> order;
+    order.reserve(origin.size());
+    std::merge(clean.cbegin(), clean.cend(), loose.cbegin(), loose.cend(),
+               std::back_inserter(order), less);
+
+    // 相邻两行都没动过时沿用快照的名次判断是否并列，否则比较排序键
+    sort_ranks_ = QVector<int>(origin.size());
+    int rank = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        const int row = order.at(i);
+        if (i > 0) {
+            const int previous = order.at(i - 1);
+            const bool same = dirty.testBit(previous) || dirty.testBit(row)
+                                  ? !less(previous, row)
+                                  : job.ranks.at(origin.at(previous)) ==
+                                        job.ranks.at(origin.at(row));
+            if (!same) ++rank;
+        }
+        sort_ranks_[row] = rank;
+    }
+    return true;
+}
+
+void xTableViewSortFilter::rebuildSortKeys() {
+    sort_keys_.clear();
+    sort_ranks_.clear();
+    const QAbstractItemModel *model = sourceModel();
+    if (!model) return;
+    for (const QPair<int, Qt::SortOrder> &entry : std::as_const(sort_columns_)) {
+        // 代理不过滤列，代理列号即源列号
+        if (entry.first >= model->columnCount()) {
+            sort_keys_.clear();
+            return;
+        }
+        xTableSortKeys keys;
+        keys.fill(model, entry.first, sortRole(), sortCaseSensitivity(), isSortLocaleAware());
+        sort_keys_.append(keys);
+    }
+    sort_ranks_ = xTableSortKeys::ranks(sort_keys_, reversedSortColumns(sort_columns_));
+}
+
+bool xTableViewSortFilter::sortKeysUsable(const QModelIndex &left,
+                                          const QModelIndex &right) const {
+    if (sort_keys_.isEmpty() || left.column() != sort_keys_.first().column()) return false;
+    const int rows = sort_keys_.first().rowCount();
+    if (left.row() >= rows || right.row() >= rows) return false;
+    for (const xTableSortKeys &keys : sort_keys_) {
+        if (!keys.matches(sortRole(), sortCaseSensitivity(), isSortLocaleAware())) return false;
+    }
+    return true;
+}
+
+bool xTableViewSortFilter::sortKeysLessThan(int left, int right) const {
+    for (int i = 0; i < sort_keys_.size(); ++i) {
+        const xTableSortKeys &keys = sort_keys_.at(i);
+        const bool reversed = sort_columns_.value(i).second != sort_columns_.first().second;
+        if (keys.lessThan(left, right)) return !reversed;
+        if (keys.lessThan(right, left)) return reversed;
+    }
+    return false;
+}
+
+bool xTableViewSortFilter::isPlaceholderRow(int sourceRow) const {
+    return table_source_ && table_source_->appendMode() &&
+           sourceRow == table_source_->baseRowCount();
+}
+
+bool xTableViewSortFilter::lessThan(const QModelIndex &source_left,
+                                    const QModelIndex &source_right) const {
+    // 追加模式下占位符行总是排在最后
+    bool leftIsPlaceholder = isPlaceholderRow(source_left.row());
+    bool rightIsPlaceholder = isPlaceholderRow(source_right.row());
     if (leftIsPlaceholder && rightIsPlaceholder) {
         // 如果两边都是占位符行，则认为它们相等
         return false;
     }
+    if (leftIsPlaceholder || rightIsPlaceholder) {
+        if (sortOrder() == Qt::AscendingOrder) {
+            return rightIsPlaceholder;
+        } else {
+            return leftIsPlaceholder;
+        }
+    }
 
-    if (sortOrder() == Qt::AscendingOrder) {
-        return rightIsPlaceholder;
-    } else {
-        return leftIsPlaceholder;
+    if (sortKeysUsable(source_left, source_right)) {
+        const int left = source_left.row();
+        const int right = source_right.row();
+        if (!sort_ranks_.isEmpty()) return sort_ranks_.at(left) < sort_ranks_.at(right);
+        return sortKeysLessThan(left, right);
     }
+    // 没有排序键时使用默认的比较逻辑
+    return QSortFilterProxyModel::lessThan(source_left, source_right);
 }
 
 bool xTableViewSortFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
-    auto source = qobject_cast<const xAbstractTableModel *>(sourceModel());
-    if (source && source->appendMode()) {
-        int placeholderRow = source->baseRowCount(sourceParent);
-        if (sourceRow == placeholderRow) {
-            return true;  // Always show the placeholder row
-        }
+    if (accepted_rows_valid_ && !sourceParent.isValid() && sourceRow < accepted_rows_.size()) {
+        return accepted_rows_.testBit(sourceRow);
+    }
+    return testRow(sourceRow, sourceParent);
+}
+
+bool xTableViewSortFilter::testRow(int sourceRow, const QModelIndex &sourceParent) const {
+    if (!sourceParent.isValid() && isPlaceholderRow(sourceRow)) {
+        return true;  // Always show the placeholder row
     }
 
     if (filters_.isEmpty()) return true;
 
     for (const xTableViewFilterRule &fr : filters_) {
-        QModelIndex idx = sourceModel()->index(sourceRow, fr.column, sourceParent);
-        if (!idx.isValid()) continue;
-        QVariant data = sourceModel()->data(idx, Qt::DisplayRole);
-        if (fr.regex.isValid() && !fr.regex.pattern().isEmpty()) {
-            if (!fr.regex.match(data.toString()).hasMatch()) return false;
-        }
-        if (fr.equals.isValid()) {
-            if (data != fr.equals) return false;
-        }
-        if (fr.hasBounds()) {
-            if (data.typeId() == QMetaType::Double || data.typeId() == QMetaType::Int) {
-                double d = data.toDouble();
-                if (d < fr.min || d > fr.max) return false;
-            }
-        }
+        if (!testRule(fr, sourceRow, sourceParent)) return false;
     }
     return true;
 }
+
+bool xTableViewSortFilter::testRule(const xTableViewFilterRule &fr, int sourceRow,
+                                    const QModelIndex &sourceParent) const {
+    if (const xTableCategoryColumn *categories = categoryColumn(fr.column, sourceRow)) {
+        const QVector<quint8> &passes = categoryPasses(fr, *categories);
+        const quint32 code = categories->code(sourceRow);
+        return passes.at(code == xTableCategoryColumn::kNull ? passes.size() - 1 : int(code));
+    }
+    if (const xTableColumnCache *cache = cachedColumn(fr.column, sourceRow)) {
+        return fr.accepts(*cache, sourceRow);
+    }
+    QModelIndex idx = sourceModel()->index(sourceRow, fr.column, sourceParent);
+    if (!idx.isValid()) return true;
+    return fr.accepts(sourceModel()->data(idx, Qt::DisplayRole));
+}
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 class xTableViewTopRowsFilter : public QSortFilterProxyModel {
   public:
@@ -254,6 +1188,34 @@ xAbstractTableModel::xAbstractTableModel(QObject *parent) : QAbstractTableModel(
     if (qApp) {
         qApp->installEventFilter(this);
     }
+    // 批处理期间插入、删除行会让暂存的行号错位，跟着平移；
+    // 重置或重排后视图整表刷新，暂存的变更直接丢掉
+    connect(this, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (parent.isValid()) return;
+                shiftBatchRows(first, last - first + 1);
+                onKeyRowsInserted(first, last);
+            });
+    connect(this, &QAbstractItemModel::rowsRemoved, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (parent.isValid()) return;
+                shiftBatchRows(first, -(last - first + 1));
+                onKeyRowsRemoved(first, last);
+            });
+    connect(this, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                ++data_changed_emits_;
+                if (key_column_ >= topLeft.column() && key_column_ <= bottomRight.column()) {
+                    updateRowKeys(topLeft.row(), bottomRight.row());
+                }
+            });
+    const auto restructured = [this]() {
+        batch_cells_.clear();
+        batch_ranges_.clear();
+        rebuildKeyIndex();
+    };
+    connect(this, &QAbstractItemModel::modelReset, this, restructured);
+    connect(this, &QAbstractItemModel::layoutChanged, this, restructured);
 }
 
 xAbstractTableModel::~xAbstractTableModel() {
@@ -299,7 +1261,8 @@ void xAbstractTableModel::setAppendMode(bool enabled, int hint_col) {
 }
 
 int xAbstractTableModel::rowCount(const QModelIndex &parent) const {
-    int realRowCount = baseRowCount(parent);
+    // appendRows 已通告、子类却拒绝建的行，在删掉之前仍要计入
+    int realRowCount = baseRowCount(parent) + (parent.isValid() ? 0 : missing_rows_);
     // 真实行数 + 1个占位符行（如果开启）
     return realRowCount + (append_mode_ ? 1 : 0);
 }
@@ -308,6 +1271,8 @@ QVariant xAbstractTableModel::data(const QModelIndex &index, int role) const {
     if (!index.isValid()) return {};
 
     int realRowCount = baseRowCount(index.parent());
+    // appendRows 通告过却没建成的行（子类中途拒绝），删掉之前按空行处理
+    if (missing_rows_ > 0 && !index.parent().isValid() && index.row() >= realRowCount) return {};
     // 检查是否是占位符行
     if (append_mode_ && index.row() == realRowCount) {
         if (role == Qt::DisplayRole && index.column() == hint_column_) {
@@ -330,6 +1295,9 @@ Qt::ItemFlags xAbstractTableModel::flags(const QModelIndex &index) const {
     if (!index.isValid()) return Qt::NoItemFlags;
 
     int realRowCount = baseRowCount(index.parent());
+    if (missing_rows_ > 0 && !index.parent().isValid() && index.row() >= realRowCount) {
+        return Qt::NoItemFlags;
+    }
     // 检查是否是占位符行
     if (append_mode_ && index.row() == realRowCount) {
         // 占位符行默认所有列都可编辑，子类可以在 baseFlags 中覆盖此行为
@@ -364,11 +1332,344 @@ bool xAbstractTableModel::setData(const QModelIndex &index, const QVariant &valu
 
         // 4. 现在 index 指向的已经是新创建的真实行了，
         //    我们调用子类的 baseSetData 来设置用户刚刚输入的值。
-        return baseSetData(index, value, role);
+        return batchedBaseSetData(index, value, role);
 
     } else {
         // 对于普通数据行，直接调用子类的实现
-        return baseSetData(index, value, role);
+        return batchedBaseSetData(index, value, role);
+    }
+}
+
+bool xAbstractTableModel::appendRows(const QVector<QVariantList> &rows) {
+    if (rows.isEmpty()) return true;
+    // 空行在 begin/endInsertRows 之间建好，一次通告；写值放在通告之后的一个批量里，
+    // 子类在 baseSetData 中发出的 dataChanged 只会指向已通告的行，经 notifyDataChanged
+    // 报的改动合并成一次 dataChanged
+    const int first = baseRowCount();
+    const int count = rows.size();
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    int inserted = 0;
+    while (inserted < count && insertNewBaseRow(first + inserted, QVariant())) ++inserted;
+    // 子类中途拒绝时通告的行数已不能改：没建成的行先按空行计入，通告完立即删掉
+    missing_rows_ = count - inserted;
+    endInsertRows();
+    if (missing_rows_ > 0) {
+        beginRemoveRows(QModelIndex(), first + inserted, first + count - 1);
+        missing_rows_ = 0;
+        endRemoveRows();
+    }
+    beginBatch();
+    for (int i = 0; i < inserted; ++i) {
+        const QVariantList &values = rows.at(i);
+        for (int column = 0; column < values.size(); ++column) {
+            batchedBaseSetData(createIndex(first + i, column), values.at(column), Qt::EditRole);
+        }
+    }
+    endBatch();
+    return inserted == count;
+}
+
+bool xAbstractTableModel::setColumnData(int column, const QVector<int> &rows,
+                                        const QVariant &value, int role) {
+    if (column < 0 || column >= columnCount()) return false;
+    QVector<int> sorted = rows;
+    std::sort(sorted.begin(), sorted.end());  // 相邻行在批量结束时合并成连续区间
+    const int baseRows = baseRowCount();
+    bool changed = false;
+    beginBatch();
+    for (int row : std::as_const(sorted)) {
+        if (row < 0 || row >= baseRows) continue;  // 占位行不参与
+        const QModelIndex idx = index(row, column);
+        if (!(flags(idx) & Qt::ItemIsEditable)) continue;
+        changed = batchedBaseSetData(idx, value, role) || changed;
+    }
+    endBatch();
+    return changed;
+}
+
+bool xAbstractTableModel::upsertRow(int keyColumn, const QVariantList &values) {
+    if (keyColumn < 0 || keyColumn >= values.size()) return false;
+    const QVariant &key = values.at(keyColumn);
+    int row = -1;
+    if (keyColumn == key_column_) {
+        row = rowForKey(key);
+    } else {
+        // 没有建键索引的列只能逐行比对
+        const int rows = baseRowCount();
+        for (int r = 0; r < rows && row < 0; ++r) {
+            if (baseData(index(r, keyColumn), Qt::EditRole) == key) row = r;
+        }
+    }
+    if (row < 0) return appendRows({values});
+
+    beginBatch();
+    bool success = true;
+    for (int column = 0; column < values.size(); ++column) {
+        if (column == keyColumn) continue;
+        success =
+            batchedBaseSetData(index(row, column), values.at(column), Qt::EditRole) && success;
+    }
+    endBatch();
+    return success;
+}
+
+void xAbstractTableModel::setKeyColumn(int column) {
+    key_column_ = qMax(column, -1);
+    rebuildKeyIndex();
+}
+
+int xAbstractTableModel::rowForKey(const QVariant &key) const {
+    if (key_column_ < 0) return -1;
+    return key_rows_.value(key.toString(), -1);
+}
+
+bool xAbstractTableModel::upsert(const QVariant &key, const QVariantList &values) {
+    if (key_column_ < 0) return false;
+    QVariantList row = values;
+    if (row.size() <= key_column_) row.resize(key_column_ + 1);
+    row[key_column_] = key;
+    return upsertRow(key_column_, row);
+}
+
+QString xAbstractTableModel::keyAt(int row) const {
+    const QModelIndex idx = index(row, key_column_);
+    QVariant key = baseData(idx, Qt::EditRole);
+    if (!key.isValid()) key = baseData(idx, Qt::DisplayRole);
+    return key.toString();
+}
+
+void xAbstractTableModel::rebuildKeyIndex() {
+    key_rows_.clear();
+    row_keys_.clear();
+    if (key_column_ < 0) return;
+    const int rows = baseRowCount();
+    row_keys_.resize(rows);
+    key_rows_.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        row_keys_[row] = keyAt(row);
+        if (!row_keys_.at(row).isEmpty()) key_rows_.insert(row_keys_.at(row), row);
+    }
+}
+
+void xAbstractTableModel::updateRowKeys(int first, int last) {
+    if (key_column_ < 0) return;
+    first = qMax(first, 0);
+    last = qMin(last, int(row_keys_.size()) - 1);
+    for (int row = first; row <= last; ++row) {
+        const QString key = keyAt(row);
+        QString &old = row_keys_[row];
+        if (key == old) continue;
+        if (!old.isEmpty() && key_rows_.value(old, -1) == row) key_rows_.remove(old);
+        if (!key.isEmpty()) key_rows_.insert(key, row);
+        old = key;
+    }
+}
+
+void xAbstractTableModel::onKeyRowsInserted(int first, int last) {
+    if (key_column_ < 0) return;
+    const int count = last - first + 1;
+    const int rows = baseRowCount();
+    if (row_keys_.size() == rows) return;  // 追加模式的占位行，不在索引里
+    if (row_keys_.size() + count != rows || first > row_keys_.size()) {
+        rebuildKeyIndex();  // 索引与数据已经对不上，整列重建
+        return;
+    }
+    row_keys_.insert(first, count, QString());
+    // 插入点之后的行号整体后移，末尾追加时这一段为空
+    for (int row = last + 1; row < rows; ++row) {
+        const QString &key = row_keys_.at(row);
+        if (!key.isEmpty() && key_rows_.value(key, -1) == row - count) key_rows_[key] = row;
+    }
+    // 新行的键通常随后才由 baseSetData 写入，届时再登记
+    updateRowKeys(first, last);
+}
+
+void xAbstractTableModel::onKeyRowsRemoved(int first, int last) {
+    if (key_column_ < 0) return;
+    const int count = last - first + 1;
+    const int rows = baseRowCount();
+    if (row_keys_.size() == rows) return;  // 占位行
+    if (row_keys_.size() - count != rows || last >= row_keys_.size()) {
+        rebuildKeyIndex();
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        const QString &key = row_keys_.at(row);
+        if (!key.isEmpty() && key_rows_.value(key, -1) == row) key_rows_.remove(key);
+    }
+    for (int row = last + 1; row < row_keys_.size(); ++row) {
+        const QString &key = row_keys_.at(row);
+        if (!key.isEmpty() && key_rows_.value(key, -1) == row) key_rows_[key] = row - count;
+    }
+    row_keys_.remove(first, count);
+}
+
+// 超过这个数目的矩形按行带合并后发出：逐个发信号的开销比多刷新几个格子更大
+static constexpr int kMaxBatchRanges = 64;
+
+void xAbstractTableModel::beginBatch() {
+    ++batch_depth_;
+}
+
+void xAbstractTableModel::endBatch() {
+    if (batch_depth_ == 0) return;
+    if (--batch_depth_ == 0) flushBatch();
+}
+
+void xAbstractTableModel::notifyDataChanged(const QModelIndex &topLeft,
+                                            const QModelIndex &bottomRight,
+                                            const QList<int> &roles) {
+    if (!topLeft.isValid() || !bottomRight.isValid()) return;
+    if (batch_depth_ == 0) {
+        emit dataChanged(topLeft, bottomRight, roles);
+        return;
+    }
+    recordBatchChange(topLeft.row(), topLeft.column(), bottomRight.row(), bottomRight.column(),
+                      roles);
+}
+
+bool xAbstractTableModel::batchedBaseSetData(const QModelIndex &index, const QVariant &value,
+                                             int role) {
+    if (batch_depth_ == 0) return baseSetData(index, value, role);
+    // 不能屏蔽信号：子类在其中插行、改表头发出的信号必须照常送达。
+    // 子类经 notifyDataChanged 报的改动已进批次；自己 emit dataChanged 的已经发出，
+    // 两者都不用再登记。什么都没报的，按全部角色登记这个单元格
+    const quint64 records = batch_records_;
+    const quint64 emits = data_changed_emits_;
+    const bool success = baseSetData(index, value, role);
+    if (success && records == batch_records_ && emits == data_changed_emits_) {
+        recordBatchChange(index.row(), index.column(), index.row(), index.column(), {});
+    }
+    return success;
+}
+
+void xAbstractTableModel::recordBatchChange(int top, int left, int bottom, int right,
+                                            const QList<int> &roles) {
+    ++batch_records_;
+    if (roles.isEmpty()) {
+        batch_all_roles_ = true;
+    } else {
+        for (int role : roles) batch_roles_.insert(role);
+    }
+    // 批处理中 dataChanged 被压住，键列的变化要当场登记，批内的 upsert 才能找到新行
+    if (key_column_ >= left && key_column_ <= right) updateRowKeys(top, bottom);
+    if (top == bottom && left == right) {
+        batch_cells_.append((quint64(top) << 32) | quint32(left));
+    } else {
+        batch_ranges_.append(QRect(QPoint(left, top), QPoint(right, bottom)));
+    }
+}
+
+void xAbstractTableModel::shiftBatchRows(int first, int count) {
+    if (batch_depth_ == 0 || count == 0) return;
+    if (count > 0) {
+        for (quint64 &cell : batch_cells_) {
+            const int row = int(cell >> 32);
+            if (row >= first) cell = (quint64(row + count) << 32) | quint32(cell);
+        }
+        for (QRect &range : batch_ranges_) {
+            if (range.top() >= first)
+                range.translate(0, count);
+            else if (range.bottom() >= first)
+                range.setBottom(range.bottom() + count);
+        }
+        return;
+    }
+
+    const int removed = -count;
+    const int last = first + removed - 1;
+    batch_cells_.erase(std::remove_if(batch_cells_.begin(), batch_cells_.end(),
+                                      [&](quint64 cell) {
+                                          const int row = int(cell >> 32);
+                                          return row >= first && row <= last;
+                                      }),
+                       batch_cells_.end());
+    for (quint64 &cell : batch_cells_) {
+        const int row = int(cell >> 32);
+        if (row > last) cell = (quint64(row - removed) << 32) | quint32(cell);
+    }
+    for (auto it = batch_ranges_.begin(); it != batch_ranges_.end();) {
+        const auto shifted = [&](int row, int inside) {
+            return row > last ? row - removed : (row >= first ? inside : row);
+        };
+        const int top = shifted(it->top(), first);
+        const int bottom = shifted(it->bottom(), first - 1);
+        if (bottom < top) {
+            it = batch_ranges_.erase(it);
+            continue;
+        }
+        it->setTop(top);
+        it->setBottom(bottom);
+        ++it;
+    }
+}
+
+void xAbstractTableModel::flushBatch() {
+    QList<int> roles;
+    if (!batch_all_roles_) {
+        roles = batch_roles_.values();
+        std::sort(roles.begin(), roles.end());
+    }
+    QVector<QRect> ranges;
+    ranges.swap(batch_ranges_);
+    QVector<quint64> cells;
+    cells.swap(batch_cells_);
+    batch_roles_.clear();
+    batch_all_roles_ = false;
+
+    // 先把同一行里相邻的列并成一段，再把上下相接、列跨度相同的段并成矩形
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    QHash<quint64, QRect> open;  // column span -> rectangle still growing downwards
+    for (int i = 0; i < cells.size();) {
+        const int row = int(cells.at(i) >> 32);
+        while (i < cells.size() && int(cells.at(i) >> 32) == row) {
+            const int left = int(quint32(cells.at(i)));
+            int right = left;
+            for (++i; i < cells.size() && cells.at(i) == cells.at(i - 1) + 1; ++i) ++right;
+            const quint64 span = (quint64(left) << 32) | quint32(right);
+            auto it = open.find(span);
+            if (it != open.end() && it->bottom() == row - 1) {
+                it->setBottom(row);
+                continue;
+            }
+            if (it != open.end()) ranges.append(*it);
+            open.insert(span, QRect(QPoint(left, row), QPoint(right, row)));
+        }
+        for (auto it = open.begin(); it != open.end();) {
+            if (it->bottom() < row) {
+                ranges.append(*it);
+                it = open.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const QRect &range : std::as_const(open)) ranges.append(range);
+    if (ranges.isEmpty()) return;
+
+    if (ranges.size() > kMaxBatchRanges) {
+        // 行区间重叠或相接的矩形并成一条行带，列取带内的外接范围；
+        // 只在列方向放宽，不会波及没有改动的行
+        std::sort(ranges.begin(), ranges.end(),
+                  [](const QRect &a, const QRect &b) { return a.top() < b.top(); });
+        QVector<QRect> bands;
+        for (const QRect &range : std::as_const(ranges)) {
+            if (!bands.isEmpty() && range.top() <= bands.last().bottom() + 1) {
+                bands.last() |= range;
+            } else {
+                bands.append(range);
+            }
+        }
+        ranges.swap(bands);
+    }
+    const int rows = rowCount();
+    const int columns = columnCount();
+    for (const QRect &range : std::as_const(ranges)) {
+        const int bottom = qMin(range.bottom(), rows - 1);
+        const int right = qMin(range.right(), columns - 1);
+        if (range.top() > bottom || range.left() > right) continue;
+        emit dataChanged(index(range.top(), range.left()), index(bottom, right), roles);
     }
 }
 
@@ -525,6 +1826,10 @@ xTableView::xTableView(QWidget *parent, bool is_column_sortable)
     horizontalHeader()->setDefaultAlignment(Qt::AlignCenter);
     if (is_column_sortable) {
         horizontalHeader()->setSectionsClickable(true);
+        // 表头点击先翻转排序箭头，QTableView 据 sortIndicatorChanged 立即按单列排一次，
+        // 之后 sectionClicked 才到 toggleSortColumn；Shift+点击因此要排两遍。断开这条连接，
+        // 排序只由 toggleSortColumn 发起（QTableView::sortByColumn 设好箭头后仍会直接排序）
+        disconnect(horizontalHeader(), &QHeaderView::sortIndicatorChanged, nullptr, nullptr);
         connect(horizontalHeader(), &QHeaderView::sectionClicked, this,
                 &xTableView::toggleSortColumn);
         horizontalHeader()->setSortIndicatorShown(true);
@@ -536,6 +1841,13 @@ xTableView::xTableView(QWidget *parent, bool is_column_sortable)
 
     connect(checkable_header_, &xCheckableHeaderView::checkboxToggled, this,
             &xTableView::onHeaderCheckboxToggled);
+    if (proxy_) {
+        // 后台排序期间在目标列表头上显示忙碌指示
+        connect(proxy_, &xTableViewSortFilter::sortStarted, checkable_header_,
+                [this](int column) { checkable_header_->setBusySection(column); });
+        connect(proxy_, &xTableViewSortFilter::sortFinished, checkable_header_,
+                [this]() { checkable_header_->setBusySection(-1); });
+    }
 
     // 设置表格字体为 Consolas, Microsoft YaHei
     QFont tableFont;
@@ -566,6 +1878,32 @@ QString xTableView::anyToString(const zce::Any &a) {
 
 bool xTableView::isEditing() const { return state() == QAbstractItemView::EditingState; }
 
+// JSON 值转成 zce::Any：整数为 i64，其余数字为 double
+static zce::Any anyFromJson(const QJsonValue &value) {
+    switch (value.type()) {
+        case QJsonValue::Bool:
+            return zce::Any(value.toBool());
+        case QJsonValue::Double: {
+            const QVariant number = value.toVariant();  // 整数为 qlonglong，其余为 double
+            if (number.typeId() == QMetaType::LongLong) {
+                return zce::Any((int64_t)number.toLongLong());
+            }
+            return zce::Any(value.toDouble());
+        }
+        case QJsonValue::String:
+            return zce::Any(value.toString().toStdString());
+        // 只有嵌套的数组和字典才需要把这一格的片段交给 Any 解析
+        case QJsonValue::Array:
+            return zce::Any::fromJsonString(
+                QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact).toStdString());
+        case QJsonValue::Object:
+            return zce::Any::fromJsonString(
+                QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact).toStdString());
+        default:
+            return zce::Any();
+    }
+}
+
 void xTableView::setItemAny(int row, int col, const zce::Any &any) {
     auto *m = qobject_cast<QStandardItemModel *>(model());
     if (!m) return;
@@ -583,8 +1921,162 @@ zce::Any xTableView::getItemAny(int row, int col) const {
 
     QVariant v = m->data(m->index(row, col), Qt::EditRole);
     if (!v.isValid()) return zce::Any();
+    if (v.userType() == qMetaTypeId<zce::Any>()) return v.value<zce::Any>();
+    // 原生标量（setRangeAny 写进类型化模型的、或别处 setData 的）也换成 Any 返回
+    return anyFromJson(QJsonValue::fromVariant(v));
+}
+
+// 整块数据只做一次 JSON 序列化/解析。xAbstractTableModel 按列类型存储，标量单元格存成
+// 原生 QVariant（排序、过滤、显示都最快），嵌套的数组和字典存成 zce::Any；其它模型与
+// setItemAny 一致，一律存 zce::Any，getItemAny 和委托的 Any 编辑器照常可用
+static QVariant cellFromJson(const QJsonValue &value, bool asAny) {
+    if (asAny && !value.isNull() && !value.isUndefined()) {
+        return QVariant::fromValue(anyFromJson(value));
+    }
+    switch (value.type()) {
+        case QJsonValue::Bool:
+            return value.toBool();
+        case QJsonValue::Double:
+            return value.toVariant();  // 整数为 qlonglong，其余为 double
+        case QJsonValue::String:
+            return value.toString();
+        case QJsonValue::Array:
+        case QJsonValue::Object:
+            return QVariant::fromValue(anyFromJson(value));
+        default:
+            return {};
+    }
+}
 
-    return v.value<zce::Any>();
+static QJsonValue cellToJson(const QVariant &data) {
+    if (data.userType() != qMetaTypeId<zce::Any>()) return QJsonValue::fromVariant(data);
+    const zce::Any a = data.value<zce::Any>();
+    if (a.is_double()) return a.dbl();
+    if (a.is_i64()) return qint64(a.i64());
+    if (a.is_boolean()) return a.boolean();
+    if (a.is_string()) return QString::fromStdString(a.str());
+    if (a.is_vector() || a.is_dict()) {
+        const QJsonDocument doc =
+            QJsonDocument::fromJson(QByteArray::fromStdString(a.toJsonString()));
+        return doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+    }
+    return QJsonValue::Null;
+}
+
+bool xTableView::setRangeAny(int row, int col, const zce::Any &matrix) {
+    QAbstractItemModel *m = proxy_ ? proxy_->sourceModel() : model();
+    if (!m || row < 0 || col < 0 || !(matrix.is_vector() || matrix.is_dict())) return false;
+    const QJsonDocument doc =
+        QJsonDocument::fromJson(QByteArray::fromStdString(matrix.toJsonString()));
+    auto *table = qobject_cast<xAbstractTableModel *>(m);
+
+    // 统一成按列排列：columns[i].second 从 row 行起写到 columns[i].first 列
+    QVector<QPair<int, QVariantList>> columns;
+    int rows = 0;
+    int dropped = 0;  // 字典里标题找不到、模型又不能加列的列数
+    if (doc.isArray()) {
+        const QJsonArray matrixRows = doc.array();
+        rows = matrixRows.size();
+        for (int r = 0; r < rows; ++r) {
+            const QJsonArray cells = matrixRows.at(r).toArray();
+            for (int c = 0; c < cells.size(); ++c) {
+                // 参差不齐的行缺的格子写成空值
+                while (columns.size() <= c) {
+                    columns.append({col + int(columns.size()), QVariantList(rows)});
+                }
+                columns[c].second[r] = cellFromJson(cells.at(c), !table);
+            }
+        }
+    } else {
+        const QJsonObject object = doc.object();
+        QHash<QString, int> titles;
+        for (int c = m->columnCount() - 1; c >= 0; --c) {
+            titles.insert(m->headerData(c, Qt::Horizontal).toString(), c);  // 同名取最左一列
+        }
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            int target = titles.value(it.key(), -1);
+            if (target < 0) {
+                target = m->columnCount();
+                if (!m->insertColumns(target, 1)) {
+                    ++dropped;  // 模型不能加列，这一列写不进去
+                    continue;
+                }
+                m->setHeaderData(target, Qt::Horizontal, it.key());
+            }
+            const QJsonArray cells = it.value().toArray();
+            QVariantList values;
+            values.reserve(cells.size());
+            for (const QJsonValue &cell : cells) values.append(cellFromJson(cell, !table));
+            rows = qMax<int>(rows, values.size());
+            columns.append({target, values});
+        }
+    }
+    if (columns.isEmpty() || rows == 0) return dropped == 0;
+
+    int lastColumn = 0;
+    for (const auto &entry : std::as_const(columns)) lastColumn = qMax(lastColumn, entry.first);
+    if (lastColumn >= m->columnCount() && !table) {
+        m->insertColumns(m->columnCount(), lastColumn - m->columnCount() + 1);
+    }
+    const int columnCount = m->columnCount();
+    // 追加模式的占位行不算数据行，新行插在它前面
+    const int existing = m->rowCount() - (table && table->appendMode() ? 1 : 0);
+    if (row > existing) return false;
+    const int inPlace = qMin(rows, existing - row);
+
+    if (table) {
+        // 已有行在批量更新里逐格写，结束时合并成一次 dataChanged；多出的行一次插入
+        table->beginBatch();
+        for (const auto &entry : std::as_const(columns)) {
+            if (entry.first >= columnCount) continue;
+            for (int r = 0; r < inPlace && r < entry.second.size(); ++r) {
+                table->setData(table->index(row + r, entry.first), entry.second.at(r));
+            }
+        }
+        table->endBatch();
+        if (inPlace == rows) return dropped == 0;
+        QVector<QVariantList> appended(rows - inPlace, QVariantList(columnCount));
+        for (const auto &entry : std::as_const(columns)) {
+            if (entry.first >= columnCount) continue;
+            for (int r = inPlace; r < entry.second.size(); ++r) {
+                appended[r - inPlace][entry.first] = entry.second.at(r);
+            }
+        }
+        return table->appendRows(appended) && dropped == 0;
+    }
+
+    if (inPlace < rows) m->insertRows(existing, rows - inPlace);
+    // 外部模型没有批量接口，也不能替它 beginResetModel：每格只写一次 EditRole 的 Any
+    // （显示文本由委托从 Any 生成；QStandardItemModel 的 EditRole 与 DisplayRole 是同一份，
+    // 再写一次显示文本只会把 Any 覆盖掉），并放行模型自己的 dataChanged / itemChanged，
+    // 不能为了合并通知把别的监听者也一并屏蔽
+    for (const auto &entry : std::as_const(columns)) {
+        if (entry.first >= columnCount) continue;
+        for (int r = 0; r < entry.second.size() && row + r < m->rowCount(); ++r) {
+            m->setData(m->index(row + r, entry.first), entry.second.at(r), Qt::EditRole);
+        }
+    }
+    return dropped == 0;
+}
+
+zce::Any xTableView::getRangeAny(int row, int col, int rows, int cols) const {
+    const QAbstractItemModel *m = proxy_ ? proxy_->sourceModel() : model();
+    QJsonArray matrix;
+    if (m && row >= 0 && col >= 0) {
+        const auto *table = qobject_cast<const xAbstractTableModel *>(m);
+        const int rowCount = m->rowCount() - (table && table->appendMode() ? 1 : 0);
+        rows = qMin(rows, rowCount - row);
+        cols = qMin(cols, m->columnCount() - col);
+        for (int r = 0; r < rows; ++r) {
+            QJsonArray cells;
+            for (int c = 0; c < cols; ++c) {
+                cells.append(cellToJson(m->data(m->index(row + r, col + c), Qt::EditRole)));
+            }
+            matrix.append(cells);
+        }
+    }
+    return zce::Any::fromJsonString(
+        QJsonDocument(matrix).toJson(QJsonDocument::Compact).toStdString());
 }
 
 void xTableView::setStretchToFill(bool enabled) {
@@ -614,22 +2106,19 @@ void xTableView::setSourceModel(QAbstractItemModel *m) {
             disconnect(oldSourceModel, &QAbstractItemModel::dataChanged, this, nullptr);
         }
 
+        // 计数器要先于代理连上源模型：代理转发插入时，新行的位已经读好
+        connectBoolColumnCounters(m);
         proxy_->setSourceModel(m);
         QTableView::setModel(proxy_);    
     } else {
         QTableView::setModel(m); 
+        connectBoolColumnCounters(m);
     }
-
-    // 连接新模型
-    if (m) {
-        connect(m, &QAbstractItemModel::dataChanged, this,
-                [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
-                    for (int col = topLeft.column(); col <= bottomRight.column(); ++col) {
-                        if (isBoolColumn(col)) {
-                            updateBoolColumnHeaderState(col);
-                        }
-                    }
-                });
+    if (search_index_) search_index_->setModel(m);
+    connectSearchInvalidation();
+    for (int col : std::as_const(bool_columns_)) {
+        rebuildBoolColumnCounter(col);
+        updateBoolColumnHeaderState(col);
     }
     syncFrozen();
 }
@@ -682,6 +2171,14 @@ QJsonObject xTableView::saveUiState() const {
     state["numberDisplayPrecision"] = getNumberDisplayPrecision();
     state["sortColumn"] = current_sort_col_;
     state["sortOrder"] = static_cast<int>(current_sort_order_);
+    QJsonArray sortColumns;
+    for (const QPair<int, Qt::SortOrder> &entry : sort_columns_) {
+        QJsonObject column;
+        column["column"] = entry.first;
+        column["order"] = static_cast<int>(entry.second);
+        sortColumns.append(column);
+    }
+    state["sortColumns"] = sortColumns;
     state["freezeColumns"] = freeze_cols_;
     state["freezeRows"] = freeze_rows_;
     state["stretchToFill"] = is_stretch_to_fill_;
@@ -793,7 +2290,18 @@ void xTableView::restoreUiState(const QJsonObject &state) {
     }
 
     const int headerColumnCount = horizontalHeader() ? horizontalHeader()->count() : 0;
-    if (state.contains("sortColumn")) {
+    const QJsonArray sortColumns = state.value("sortColumns").toArray();
+    if (sortColumns.size() > 1) {
+        QVector<QPair<int, Qt::SortOrder>> columns;
+        for (const QJsonValue &value : sortColumns) {
+            const QJsonObject column = value.toObject();
+            const int sortColumn = column.value("column").toInt(-1);
+            if (sortColumn >= 0 && sortColumn < headerColumnCount) {
+                columns.append(qMakePair(sortColumn, jsonToSortOrder(column.value("order"))));
+            }
+        }
+        sortByColumns(columns);
+    } else if (state.contains("sortColumn")) {
         const int sortColumn = state.value("sortColumn").toInt(-1);
         const Qt::SortOrder sortOrder = jsonToSortOrder(state.value("sortOrder"));
         if (sortColumn >= 0 && sortColumn < headerColumnCount) {
@@ -854,6 +2362,9 @@ void xTableView::clearFilters() { proxy_->clearFilters(); }
 void xTableView::sortBy(int col, Qt::SortOrder ord) {
     current_sort_col_ = col;
     current_sort_order_ = col >= 0 ? ord : Qt::AscendingOrder;
+    sort_columns_.clear();
+    if (col >= 0) sort_columns_.append(qMakePair(col, ord));
+    checkable_header_->setSortColumns(sort_columns_);
 
     if (col >= 0) {
         if (horizontalHeader()) {
@@ -875,6 +2386,161 @@ void xTableView::sortBy(int col, Qt::SortOrder ord) {
     }
 }
 
+void xTableView::sortByColumns(const QVector<QPair<int, Qt::SortOrder>> &columns) {
+    if (columns.size() < 2 || !proxy_) {
+        if (columns.isEmpty())
+            sortBy(-1, Qt::AscendingOrder);
+        else
+            sortBy(columns.first().first, columns.first().second);
+        return;
+    }
+
+    current_sort_col_ = columns.first().first;
+    current_sort_order_ = columns.first().second;
+    sort_columns_ = columns;
+    if (horizontalHeader()) {
+        // 箭头只标主排序列；屏蔽信号，免得 QTableView 据此再按单列排一次
+        QSignalBlocker blocker(horizontalHeader());
+        horizontalHeader()->setSortIndicatorShown(true);
+        horizontalHeader()->setSortIndicator(current_sort_col_, current_sort_order_);
+    }
+    checkable_header_->setSortColumns(sort_columns_);
+    proxy_->sortByColumns(sort_columns_);
+}
+
+int xTableView::findText(const QString &text) {
+    search_text_ = text;
+    search_hits_valid_ = false;
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    if (!search_index_ && source && !text.isEmpty()) {
+        search_index_ = new xTableSearchIndex(this);
+        search_index_->setModel(source);
+        connect(search_index_, &xTableSearchIndex::cellsChanged, this,
+                &xTableView::onSearchCellsChanged);
+    }
+    ensureSearchHits();
+    stepSearch(true, true);
+    if (highlight_all_) viewport()->update();
+    return search_hits_.size();
+}
+
+bool xTableView::findNext() { return stepSearch(true, false); }
+
+bool xTableView::findPrevious() { return stepSearch(false, false); }
+
+void xTableView::setHighlightAll(bool enabled) {
+    if (highlight_all_ == enabled) return;
+    highlight_all_ = enabled;
+    viewport()->update();
+}
+
+bool xTableView::isSearchHighlighted(const QModelIndex &index) const {
+    if (!highlight_all_ || search_text_.isEmpty() || index.model() != model()) return false;
+    ensureSearchHits();
+    return std::binary_search(search_hits_.cbegin(), search_hits_.cend(),
+                              qMakePair(index.row(), index.column()));
+}
+
+void xTableView::ensureSearchHits() const {
+    if (!search_index_ || search_text_.isEmpty()) {
+        search_hits_.clear();
+        search_hits_valid_ = true;
+        return;
+    }
+    if (search_hits_valid_ && search_version_ == search_index_->version()) return;
+
+    // 索引给出源模型中的命中，换算成视图坐标并排好序，之后的上一个/下一个只需二分查找
+    const QModelIndexList matches = search_index_->find(search_text_);
+    search_version_ = search_index_->version();
+    search_hits_.clear();
+    search_hits_.reserve(matches.size());
+    for (const QModelIndex &match : matches) {
+        const QModelIndex index = proxy_ ? proxy_->mapFromSource(match) : match;
+        if (index.isValid() && !isColumnHidden(index.column())) {
+            search_hits_.append(qMakePair(index.row(), index.column()));
+        }
+    }
+    std::sort(search_hits_.begin(), search_hits_.end());
+    search_hits_valid_ = true;
+}
+
+// 超过这么多个单元格的改动不逐格修补，下次用到时整体重查
+static constexpr qint64 kMaxSearchPatchCells = 4096;
+
+void xTableView::onSearchCellsChanged(const QModelIndex &topLeft,
+                                      const QModelIndex &bottomRight) {
+    // 只有命中表恰好落后这一次改动时才能就地修补，否则留给 ensureSearchHits 整体重查
+    if (!search_hits_valid_ || search_text_.isEmpty() ||
+        search_version_ + 1 != search_index_->version()) {
+        return;
+    }
+    const qint64 cells = qint64(bottomRight.row() - topLeft.row() + 1) *
+                         (bottomRight.column() - topLeft.column() + 1);
+    if (cells > kMaxSearchPatchCells) return;
+    // 只重判改动的单元格；代理若因此重新过滤、排序，随后的行信号会让命中表整体作废
+    const QAbstractItemModel *source = search_index_->model();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        for (int column = topLeft.column(); column <= bottomRight.column(); ++column) {
+            const QModelIndex sourceIndex = source->index(row, column);
+            const QModelIndex index = proxy_ ? proxy_->mapFromSource(sourceIndex) : sourceIndex;
+            if (!index.isValid() || isColumnHidden(index.column())) continue;
+            const QPair<int, int> cell(index.row(), index.column());
+            auto it = std::lower_bound(search_hits_.begin(), search_hits_.end(), cell);
+            const bool listed = it != search_hits_.end() && *it == cell;
+            const bool hit = search_index_->cellContains(row, column, search_text_);
+            if (hit && !listed) {
+                search_hits_.insert(it, cell);
+            } else if (!hit && listed) {
+                search_hits_.erase(it);
+            }
+        }
+    }
+    search_version_ = search_index_->version();
+}
+
+bool xTableView::stepSearch(bool forward, bool inclusive) {
+    ensureSearchHits();
+    if (search_hits_.isEmpty()) return false;
+
+    const QModelIndex current = currentIndex();
+    const QPair<int, int> here =
+        current.isValid() ? qMakePair(current.row(), current.column()) : qMakePair(-1, -1);
+    int pos;
+    if (forward) {
+        auto it = inclusive ? std::lower_bound(search_hits_.cbegin(), search_hits_.cend(), here)
+                            : std::upper_bound(search_hits_.cbegin(), search_hits_.cend(), here);
+        pos = it == search_hits_.cend() ? 0 : int(it - search_hits_.cbegin());  // 到底后回到开头
+    } else {
+        auto it = std::lower_bound(search_hits_.cbegin(), search_hits_.cend(), here);
+        pos = it == search_hits_.cbegin() ? search_hits_.size() - 1
+                                          : int(it - search_hits_.cbegin()) - 1;
+    }
+
+    const QModelIndex target = model()->index(search_hits_.at(pos).first,
+                                              search_hits_.at(pos).second);
+    setCurrentIndex(target);
+    scrollTo(target);
+    return true;
+}
+
+void xTableView::connectSearchInvalidation() {
+    for (const QMetaObject::Connection &connection : std::as_const(search_connections_)) {
+        disconnect(connection);
+    }
+    search_connections_.clear();
+    search_hits_valid_ = false;
+    QAbstractItemModel *viewModel = model();
+    if (!viewModel) return;
+
+    // 过滤、排序都会改变视图行号；单元格内容的变化由索引版本号反映
+    const auto invalidate = [this]() { search_hits_valid_ = false; };
+    search_connections_ << connect(viewModel, &QAbstractItemModel::layoutChanged, this, invalidate);
+    search_connections_ << connect(viewModel, &QAbstractItemModel::modelReset, this, invalidate);
+    search_connections_ << connect(viewModel, &QAbstractItemModel::rowsInserted, this, invalidate);
+    search_connections_ << connect(viewModel, &QAbstractItemModel::rowsRemoved, this, invalidate);
+    search_connections_ << connect(viewModel, &QAbstractItemModel::rowsMoved, this, invalidate);
+}
+
 void xTableView::freezeLeftColumns(int n) {
     freeze_cols_ = n > 0 ? n : 0;
     syncFrozen();
@@ -916,6 +2582,14 @@ void xTableView::keyPressEvent(QKeyEvent *ev) {
         emit findRequested();
         ev->accept();
         return;
+    } else if (ev->matches(QKeySequence::FindNext)) {
+        findNext();
+        ev->accept();
+        return;
+    } else if (ev->matches(QKeySequence::FindPrevious)) {
+        findPrevious();
+        ev->accept();
+        return;
     }
     QTableView::keyPressEvent(ev);
 }
@@ -991,6 +2665,23 @@ void xTableView::showHeaderMenu(const QPoint &pos) {
 void xTableView::toggleSortColumn(int logicalCol) {
     if (logicalCol < 0) return;
 
+    if ((QApplication::keyboardModifiers() & Qt::ShiftModifier) && current_sort_col_ >= 0) {
+        // Shift+点击：追加为次要排序列，再次 Shift+点击依次切换为降序、移出排序
+        QVector<QPair<int, Qt::SortOrder>> columns = sort_columns_;
+        auto it = std::find_if(columns.begin(), columns.end(),
+                               [&](const QPair<int, Qt::SortOrder> &entry) {
+                                   return entry.first == logicalCol;
+                               });
+        if (it == columns.end())
+            columns.append(qMakePair(logicalCol, Qt::AscendingOrder));
+        else if (it->second == Qt::AscendingOrder)
+            it->second = Qt::DescendingOrder;
+        else
+            columns.erase(it);
+        sortByColumns(columns);
+        return;
+    }
+
     if (logicalCol == current_sort_col_) {
         // 第2次或第3次点击同一个已排序的列
         if (current_sort_order_ == Qt::AscendingOrder) {
@@ -1006,26 +2697,109 @@ void xTableView::toggleSortColumn(int logicalCol) {
     }
 }
 
+// 区间 [first, last] 排序并合并重叠、相邻的部分
+static QVector<QPair<int, int>> mergeSpans(QVector<QPair<int, int>> spans) {
+    std::sort(spans.begin(), spans.end());
+    QVector<QPair<int, int>> merged;
+    for (const auto &span : std::as_const(spans)) {
+        if (!merged.isEmpty() && span.first <= merged.last().second + 1) {
+            merged.last().second = qMax(merged.last().second, span.second);
+        } else {
+            merged.append(span);
+        }
+    }
+    return merged;
+}
+
+// 选区按行切成若干段，段内每行选中的列相同；列合并成升序、不重叠的区间。
+// 每个范围在 top 处加入、bottom + 1 处移出，按行扫一遍事件，活动集合就是当前段选中的列；
+// 开销与范围个数及输出大小有关，与单元格数无关
+static QVector<xSelectionBand> selectionBands(const QItemSelection &selection) {
+    struct Event {
+        int row;
+        int delta;
+        QPair<int, int> span;
+    };
+    QVector<Event> events;
+    events.reserve(selection.size() * 2);
+    for (const QItemSelectionRange &range : selection) {
+        if (!range.isValid()) continue;
+        const QPair<int, int> span(range.left(), range.right());
+        events.append({range.top(), 1, span});
+        events.append({range.bottom() + 1, -1, span});
+    }
+    std::sort(events.begin(), events.end(),
+              [](const Event &a, const Event &b) { return a.row < b.row; });
+
+    QMap<QPair<int, int>, int> active;  // 列区间 -> 覆盖当前行的范围个数
+    QVector<xSelectionBand> bands;
+    for (int i = 0; i < events.size();) {
+        const int row = events[i].row;
+        for (; i < events.size() && events[i].row == row; ++i) {
+            const int covered = active.value(events[i].span) + events[i].delta;
+            if (covered > 0) {
+                active.insert(events[i].span, covered);
+            } else {
+                active.remove(events[i].span);
+            }
+        }
+        if (active.isEmpty()) continue;
+        const int next = events[i].row;  // 还有范围未移出，后面必有事件
+        const QVector<QPair<int, int>> columns =
+            mergeSpans(QVector<QPair<int, int>>(active.keyBegin(), active.keyEnd()));
+        if (!bands.isEmpty() && bands.last().last + 1 == row && bands.last().columns == columns) {
+            bands.last().last = next - 1;
+        } else {
+            bands.append({row, next - 1, columns});
+        }
+    }
+    return bands;
+}
+
+// 超过这么多个单元格的复制交给后台，以免 GUI 线程卡住
+static constexpr qint64 kBackgroundCopyCells = 200 * 1000;
+
+// 视图行换成源模型行；源模型里仍相邻、选中列也相同的行并成一段（跨视图段也并），
+// 没排序时段数不变。顺序仍按视图行，复制结果与屏幕上一致。代理不过滤列，列号照旧
+static QVector<xSelectionBand> sourceBands(const QAbstractProxyModel *proxy,
+                                           const QVector<xSelectionBand> &bands) {
+    QVector<xSelectionBand> mapped;
+    for (const xSelectionBand &band : bands) {
+        const int run = mapped.size();
+        for (int row = band.first; row <= band.last; ++row) {
+            const int sourceRow = proxy->mapToSource(proxy->index(row, 0)).row();
+            if (sourceRow < 0) continue;
+            if (!mapped.isEmpty() && mapped.last().last + 1 == sourceRow &&
+                (mapped.size() > run || mapped.last().columns == band.columns)) {
+                mapped.last().last = sourceRow;
+            } else {
+                mapped.append({sourceRow, sourceRow, band.columns});  // 列区间隐式共享
+            }
+        }
+    }
+    return mapped;
+}
+
 void xTableView::copySelection() {
-    QItemSelection sel = selectionModel()->selection();
+    const QItemSelection sel = selectionModel()->selection();
     if (sel.isEmpty()) return;
-    QModelIndexList indexes = sel.indexes();
-    if (indexes.isEmpty()) return;
-    QMap<int, QMap<int, QString>> rowData;
-    for (const QModelIndex &index : indexes) {
-        rowData[index.row()][index.column()] = index.data(Qt::DisplayRole).toString();
+    QVector<xSelectionBand> bands = selectionBands(sel);
+    if (bands.isEmpty()) return;
+    // 小选区当场复制；大选区分块在后台序列化，界面不卡，并显示进度
+    if (xTableClipboardCopy::cellCount(bands) <= kBackgroundCopyCells) {
+        QApplication::clipboard()->setMimeData(xTableClipboardCopy::mimeData(model(), bands));
+        return;
     }
-    QString text;
-    for (auto it = rowData.constBegin(); it != rowData.constEnd(); ++it) {
-        QStringList line;
-        for (auto jt = it.value().constBegin(); jt != it.value().constEnd(); ++jt) {
-            line << jt.value();
-        }
-        text += line.join("\t");
-        text += "\n";
+    if (clipboard_copy_) clipboard_copy_->cancel();
+    // 后台复制按源模型行读：代理在这期间重排、重新过滤都不影响，
+    // 源模型的插入删除由复制对象平移尚未读到的行
+    QAbstractItemModel *source = model();
+    if (proxy_ && proxy_->sourceModel()) {
+        source = proxy_->sourceModel();
+        bands = sourceBands(proxy_, bands);
     }
-    text.chop(1);
-    QApplication::clipboard()->setText(text);
+    clipboard_copy_ = new xTableClipboardCopy(source, std::move(bands), this);
+    clipboard_copy_->start();
 }
 
 void xTableView::paste() {
@@ -1047,31 +2821,50 @@ void xTableView::paste() {
 }
 
 void xTableView::removeSelectedCells() {
-    auto sel = selectionModel()->selectedIndexes();
-    for (const QModelIndex &idx : sel) {
-        if (idx.isValid() && (idx.flags() & Qt::ItemIsEditable))
-            model()->setData(idx, QVariant(), Qt::EditRole);
+    const QItemSelection sel = selectionModel()->selection();
+    if (sel.isEmpty()) return;
+    // 源模型支持批量时，整个选区的改动合并成少数几次 dataChanged
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    auto *table = qobject_cast<xAbstractTableModel *>(source);
+    if (table) table->beginBatch();
+    for (const xSelectionBand &band : selectionBands(sel)) {
+        for (const auto &span : band.columns) {
+            for (int row = band.first; row <= band.last; ++row) {
+                for (int col = span.first; col <= span.second; ++col) {
+                    const QModelIndex idx = model()->index(row, col);
+                    if (idx.isValid() && (idx.flags() & Qt::ItemIsEditable))
+                        model()->setData(idx, QVariant(), Qt::EditRole);
+                }
+            }
+        }
     }
+    if (table) table->endBatch();
 }
 
 void xTableView::removeSelectedRows() {
-    const QModelIndexList sel = selectionModel()->selectedIndexes();
+    const QItemSelection sel = selectionModel()->selection();
     if (sel.isEmpty()) return;
 
-    QSet<int> distinctRows;
-    for (const QModelIndex &idx : sel) {
-        if (idx.isValid()) {
-            // 这里可以加上权限判断，比如是否允许删除
-            // 注意：Qt::ItemIsEditable 通常指能否修改文本，不一定代表能否删除行
-            // if (model()->flags(idx) & Qt::ItemIsEditable) {
-            distinctRows.insert(idx.row());
-            // }
+    // 这里可以加上权限判断，比如是否允许删除
+    // 注意：Qt::ItemIsEditable 通常指能否修改文本，不一定代表能否删除行
+    QVector<QPair<int, int>> rows;
+    rows.reserve(sel.size());
+    for (const QItemSelectionRange &range : sel) {
+        if (range.isValid()) rows.append(qMakePair(range.top(), range.bottom()));
+    }
+    // 连续的行一次删除，从后往前删，前面块的行号不受影响
+    QVector<QPair<int, int>> blocks = mergeSpans(rows);
+    // 追加模式的占位行总在最后，不能删；把它从最后一块里去掉，免得整块删除失败
+    auto *table = qobject_cast<xAbstractTableModel *>(proxy_ ? proxy_->sourceModel() : model());
+    if (table && !blocks.isEmpty()) {
+        const int last = blocks.last().second;
+        const int sourceRow = proxy_ ? proxy_->mapToSource(proxy_->index(last, 0)).row() : last;
+        if (table->isPlaceholderRow(sourceRow) && --blocks.last().second < blocks.last().first) {
+            blocks.removeLast();
         }
     }
-    QList<int> sortedRows = distinctRows.values();
-    std::sort(sortedRows.begin(), sortedRows.end(), std::greater<int>());
-    for (int row : sortedRows) {
-        model()->removeRows(row, 1);
+    for (auto it = blocks.crbegin(); it != blocks.crend(); ++it) {
+        model()->removeRows(it->first, it->second - it->first + 1);
     }
 }
 
@@ -1212,10 +3005,12 @@ void xTableView::updateFrozenGeometry() {
 void xTableView::setBoolColumn(int column, bool enabled) {
     if (enabled) {
         bool_columns_.insert(column);
+        rebuildBoolColumnCounter(column);
     } else {
         bool_columns_.remove(column);
         // 也清理内存状态
         bool_column_memory_states_.remove(column);
+        bool_column_counters_.remove(column);
     }
     // 通知自定义的表头这一变化
     checkable_header_->setBoolColumn(column, enabled);
@@ -1238,6 +3033,14 @@ Qt::CheckState xTableView::calculateBoolColumnState(int column) const {
     int checkedCount = 0;
     int validCount = 0;
 
+    auto counter = bool_column_counters_.constFind(column);
+    if (counter != bool_column_counters_.constEnd() && counter->counted_rows == totalRows) {
+        // 计数器随模型信号增量维护，不必逐行读取
+        checkedCount = counter->checked_count;
+        validCount = counter->valid_count;
+        totalRows = 0;
+    }
+
     for (int row = 0; row < totalRows; ++row) {
         QModelIndex idx = model()->index(row, column);
         if (idx.isValid()) {
@@ -1268,26 +3071,48 @@ void xTableView::onHeaderCheckboxToggled(int column, Qt::CheckState state) {
         if (calculateBoolColumnState(column) == Qt::PartiallyChecked) {
             saveBoolColumnMemoryState(column);
         }
-        // 将所有行设置为 true
-        for (int row = 0; row < model()->rowCount(); ++row) {
-            QModelIndex idx = model()->index(row, column);
-            if (idx.isValid() && (idx.flags() & Qt::ItemIsEditable)) {
-                model()->setData(idx, true, Qt::EditRole);
-            }
-        }
+        // 将所有可见行设置为 true
+        setColumnRows(column, true);
     } else {  // state == Qt::Unchecked
-              // 将所有行设置为 false
-        for (int row = 0; row < model()->rowCount(); ++row) {
-            QModelIndex idx = model()->index(row, column);
-            if (idx.isValid() && (idx.flags() & Qt::ItemIsEditable)) {
-                model()->setData(idx, false, Qt::EditRole);
-            }
-        }
+              // 将所有可见行设置为 false
+        setColumnRows(column, false);
     }
 
     // 数据模型改变后，它会发出 dataChanged 信号，我们用它来更新表头最终的状态
 }
 
+void xTableView::setColumnRows(int column, const QVariant &value) {
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    if (!source) return;
+    // 可见行换算成源模型行，整列一次写入，不经代理逐行 setData
+    const int rows = model()->rowCount();
+    QVector<int> sourceRows;
+    sourceRows.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        sourceRows.append(proxy_ ? proxy_->mapToSource(proxy_->index(row, column)).row() : row);
+    }
+
+    setSourceColumnRows(column, sourceRows, value);
+}
+
+void xTableView::setSourceColumnRows(int column, const QVector<int> &sourceRows,
+                                     const QVariant &value) {
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    if (!source || sourceRows.isEmpty()) return;
+    if (auto *table = qobject_cast<xAbstractTableModel *>(source)) {
+        table->setColumnData(column, sourceRows, value);
+        return;
+    }
+    // 其它模型没有批量接口：逐行 setData，通知照常由模型自己发出。屏蔽信号再补发一次
+    // dataChanged 会把 itemChanged 之类只有模型自己能发的信号一起吞掉
+    for (int row : std::as_const(sourceRows)) {
+        const QModelIndex idx = source->index(row, column);
+        if (idx.isValid() && (idx.flags() & Qt::ItemIsEditable)) {
+            source->setData(idx, value, Qt::EditRole);
+        }
+    }
+}
+
 void xTableView::updateBoolColumnHeaderState(int column) {
     if (isBoolColumn(column)) {
         Qt::CheckState state = calculateBoolColumnState(column);
@@ -1295,48 +3120,345 @@ void xTableView::updateBoolColumnHeaderState(int column) {
     }
 }
 
-void xTableView::saveBoolColumnMemoryState(int column) {
-    if (!model()) return;
-
-    QVector<bool> states;
-    int totalRows = model()->rowCount();
+void xTableView::connectBoolColumnCounters(QAbstractItemModel *source) {
+    for (const QMetaObject::Connection &connection : std::as_const(bool_counter_connections_)) {
+        disconnect(connection);
+    }
+    bool_counter_connections_.clear();
+    bool_column_memory_states_.clear();
+    if (!source) return;
 
-    for (int row = 0; row < totalRows; ++row) {
-        QModelIndex idx = model()->index(row, column);
-        if (idx.isValid()) {
-            QVariant data = idx.data(Qt::EditRole);
-            if (data.typeId() == QMetaType::Bool) {
-                states.append(data.toBool());
-            } else {
-                states.append(false);  // default for non-bool items
+    // 逐行的位按源模型行存，总数只算视图里可见的行：代理排序只换行序，位图和总数都不用动；
+    // 过滤变化由代理发成行的插入删除，按映射到的源行增减
+    bool_counter_connections_ << connect(
+        source, &QAbstractItemModel::dataChanged, this,
+        [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+            if (topLeft.parent().isValid()) return;
+            for (int col = topLeft.column(); col <= bottomRight.column(); ++col) {
+                if (!bool_column_counters_.contains(col)) continue;
+                countBoolRows(col, topLeft.row(), bottomRight.row());
+                updateBoolColumnHeaderState(col);
             }
-        } else {
-            states.append(false);
+        });
+    // 记住的勾选状态同样按源模型行存，随插入删除平移；行被重排或重置后无从对应，丢弃
+    bool_counter_connections_ << connect(
+        source, &QAbstractItemModel::rowsInserted, this,
+        [this](const QModelIndex &parent, int first, int last) {
+            if (parent.isValid()) return;
+            for (BoolColumnMemory &memory : bool_column_memory_states_) {
+                memory.insertRows(first, last - first + 1);
+            }
+            for (auto it = bool_column_counters_.begin(); it != bool_column_counters_.end();
+                 ++it) {
+                BoolColumnCounter &counter = *it;
+                if (first > counter.valid.size()) {
+                    rebuildBoolColumnCounter(it.key());
+                    continue;
+                }
+                counter.valid.insert(first, last - first + 1);
+                counter.checked.insert(first, last - first + 1);
+                counter.counted.insert(first, last - first + 1);
+                countBoolRows(it.key(), first, last);
+                // 代理先于这里转发了插入时，那些行没能计入，补数一遍
+                if (counter.counted_rows < 0) recountBoolColumn(it.key());
+            }
+        });
+    // 可见行在视图的 rowsAboutToBeRemoved 里已经扣减过，这里只平移位图
+    bool_counter_connections_ << connect(
+        source, &QAbstractItemModel::rowsRemoved, this,
+        [this](const QModelIndex &parent, int first, int last) {
+            if (parent.isValid()) return;
+            for (BoolColumnMemory &memory : bool_column_memory_states_) {
+                memory.removeRows(first, last - first + 1);
+            }
+            for (BoolColumnCounter &counter : bool_column_counters_) {
+                if (last >= counter.valid.size()) continue;  // 已失配，等重建
+                counter.valid.remove(first, last - first + 1);
+                counter.checked.remove(first, last - first + 1);
+                counter.counted.remove(first, last - first + 1);
+            }
+        });
+    // 源模型自己重排或重置，按行号存的位全部作废，重读
+    const auto reread = [this]() {
+        bool_column_memory_states_.clear();
+        for (int col : bool_column_counters_.keys()) {
+            rebuildBoolColumnCounter(col);
+            // 代理随后发出自己的重置或重排，到那时按新的映射再数可见行
+            if (proxy_) bool_column_counters_[col].counted_rows = -1;
+            updateBoolColumnHeaderState(col);
+        }
+    };
+    bool_counter_connections_ << connect(source, &QAbstractItemModel::modelReset, this, reread);
+    bool_counter_connections_ << connect(source, &QAbstractItemModel::rowsMoved, this, reread);
+    bool_counter_connections_ << connect(source, &QAbstractItemModel::layoutChanged, this, reread);
+
+    QAbstractItemModel *view = proxy_ ? static_cast<QAbstractItemModel *>(proxy_) : source;
+    bool_counter_connections_ << connect(
+        view, &QAbstractItemModel::rowsInserted, this,
+        [this](const QModelIndex &parent, int first, int last) {
+            if (parent.isValid()) return;
+            for (auto it = bool_column_counters_.begin(); it != bool_column_counters_.end();
+                 ++it) {
+                BoolColumnCounter &counter = *it;
+                if (counter.counted_rows < 0) continue;
+                for (int row = first; row <= last; ++row) {
+                    const int sourceRow = boolSourceRow(row);
+                    if (sourceRow < 0 || sourceRow >= counter.valid.size()) {
+                        counter.counted_rows = -1;  // 源模型的插入还没处理到
+                        break;
+                    }
+                    if (counter.counted.testBit(sourceRow)) continue;
+                    counter.counted.setBit(sourceRow);
+                    ++counter.counted_rows;
+                    counter.valid_count += counter.valid.testBit(sourceRow);
+                    counter.checked_count += counter.checked.testBit(sourceRow);
+                }
+                updateBoolColumnHeaderState(it.key());
+            }
+        });
+    // 删除前行还在，代理的映射也还在，按源行扣减
+    bool_counter_connections_ << connect(
+        view, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+        [this](const QModelIndex &parent, int first, int last) {
+            if (parent.isValid()) return;
+            for (BoolColumnCounter &counter : bool_column_counters_) {
+                if (counter.counted_rows < 0) continue;
+                for (int row = first; row <= last; ++row) {
+                    const int sourceRow = boolSourceRow(row);
+                    if (sourceRow < 0 || sourceRow >= counter.counted.size() ||
+                        !counter.counted.testBit(sourceRow)) {
+                        continue;
+                    }
+                    counter.counted.setBit(sourceRow, false);
+                    --counter.counted_rows;
+                    counter.valid_count -= counter.valid.testBit(sourceRow);
+                    counter.checked_count -= counter.checked.testBit(sourceRow);
+                }
+            }
+        });
+    bool_counter_connections_ << connect(
+        view, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &parent) {
+            if (parent.isValid()) return;
+            for (int col : bool_column_counters_.keys()) updateBoolColumnHeaderState(col);
+        });
+    if (!proxy_) return;
+    // 排序只换行序，可见行的集合不变；其他重排（如整体重新过滤）按已有的位重算可见集合，
+    // 不再逐行读数据
+    bool_counter_connections_ << connect(
+        proxy_, &QAbstractItemModel::layoutChanged, this,
+        [this](const QList<QPersistentModelIndex> &,
+               QAbstractItemModel::LayoutChangeHint hint) {
+            for (int col : bool_column_counters_.keys()) {
+                if (hint == QAbstractItemModel::VerticalSortHint &&
+                    bool_column_counters_[col].counted_rows >= 0) {
+                    continue;
+                }
+                recountBoolColumn(col);
+                updateBoolColumnHeaderState(col);
+            }
+        });
+    const auto recount = [this]() {
+        for (int col : bool_column_counters_.keys()) {
+            recountBoolColumn(col);
+            updateBoolColumnHeaderState(col);
         }
+    };
+    bool_counter_connections_ << connect(proxy_, &QAbstractItemModel::modelReset, this, recount);
+    bool_counter_connections_ << connect(proxy_, &QAbstractItemModel::rowsMoved, this, recount);
+}
+
+int xTableView::boolSourceRow(int row) const {
+    return proxy_ ? proxy_->mapToSource(proxy_->index(row, 0)).row() : row;
+}
+
+void xTableView::rebuildBoolColumnCounter(int column) {
+    BoolColumnCounter &counter = bool_column_counters_[column];
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    const int rows = source ? source->rowCount() : 0;
+    counter.valid = xTableBitmap(rows);
+    counter.checked = xTableBitmap(rows);
+    counter.counted = xTableBitmap(rows);
+    counter.counted_rows = 0;
+    counter.valid_count = 0;
+    counter.checked_count = 0;
+    countBoolRows(column, 0, rows - 1);
+    recountBoolColumn(column);
+}
+
+void xTableView::recountBoolColumn(int column) {
+    auto it = bool_column_counters_.find(column);
+    if (it == bool_column_counters_.end()) return;
+    BoolColumnCounter &counter = *it;
+    counter.counted = xTableBitmap(counter.valid.size());
+    counter.counted_rows = 0;
+    counter.valid_count = 0;
+    counter.checked_count = 0;
+    const int rows = model() ? model()->rowCount() : 0;
+    for (int row = 0; row < rows; ++row) {
+        const int sourceRow = boolSourceRow(row);
+        if (sourceRow < 0 || sourceRow >= counter.valid.size()) {
+            counter.counted_rows = -1;  // 位图与源模型失配，等源模型的信号重建
+            return;
+        }
+        counter.counted.setBit(sourceRow);
+        ++counter.counted_rows;
+        counter.valid_count += counter.valid.testBit(sourceRow);
+        counter.checked_count += counter.checked.testBit(sourceRow);
     }
+}
 
-    bool_column_memory_states_[column] = states;
+void xTableView::countBoolRows(int column, int first, int last) {
+    auto it = bool_column_counters_.find(column);
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    if (it == bool_column_counters_.end() || !source) return;
+    BoolColumnCounter &counter = *it;
+    if (counter.valid.size() != source->rowCount()) {
+        rebuildBoolColumnCounter(column);
+        return;
+    }
+    first = qMax(first, 0);
+    last = qMin(last, counter.valid.size() - 1);
+    for (int row = first; row <= last; ++row) {
+        const QVariant data = source->index(row, column).data(Qt::EditRole);
+        const bool valid = data.typeId() == QMetaType::Bool;
+        const bool checked = valid && data.toBool();
+        // 不可见的行只记位，不计入总数
+        if (counter.counted.testBit(row)) {
+            counter.valid_count += int(valid) - int(counter.valid.testBit(row));
+            counter.checked_count += int(checked) - int(counter.checked.testBit(row));
+        }
+        counter.valid.setBit(row, valid);
+        counter.checked.setBit(row, checked);
+    }
 }
 
-void xTableView::restoreBoolColumnMemoryState(int column) {
-    if (!model()) return;
+bool xTableView::BoolColumnMemory::value(int row) const {
+    if (!sparse) return checked.testBit(row);
+    return std::binary_search(exceptions.cbegin(), exceptions.cend(), row) ? !common : common;
+}
 
-    auto it = bool_column_memory_states_.find(column);
-    if (it == bool_column_memory_states_.end()) {
-        return;  // No memory state saved
-    }
+// 第一个结束于 row 及其后的区间
+static QVector<QPair<int, int>>::iterator runAtOrAfter(QVector<QPair<int, int>> &runs, int row) {
+    return std::lower_bound(runs.begin(), runs.end(), row,
+                            [](const QPair<int, int> &run, int r) { return run.second < r; });
+}
 
-    const QVector<bool> &states = it.value();
-    int totalRows = model()->rowCount();
-    int stateCount = states.size();
+bool xTableView::BoolColumnMemory::known(int row) const {
+    if (row >= rows) return false;
+    auto it = std::lower_bound(added.cbegin(), added.cend(), row,
+                               [](const QPair<int, int> &run, int r) { return run.second < r; });
+    return it == added.cend() || it->first > row;
+}
 
-    for (int row = 0; row < totalRows && row < stateCount; ++row) {
-        QModelIndex idx = model()->index(row, column);
-        if (idx.isValid() && (idx.flags() & Qt::ItemIsEditable)) {
-            QVariant data = idx.data(Qt::EditRole);
-            if (data.typeId() == QMetaType::Bool) {
-                model()->setData(idx, states[row], Qt::EditRole);
-            }
+void xTableView::BoolColumnMemory::insertRows(int first, int count) {
+    if (first > rows) return;
+    // 新增行按区间记：插入点及之后的区间后移，新区间与紧挨着的区间合并
+    const int last = first + count - 1;
+    auto it = runAtOrAfter(added, first - 1);
+    for (auto run = it; run != added.end(); ++run) {
+        if (run->first >= first) run->first += count;
+        if (run->second >= first) run->second += count;
+    }
+    if (it != added.end() && it->first <= last + 1) {
+        it->first = qMin(it->first, first);
+        it->second = qMax(it->second, last);
+        auto next = it + 1;
+        if (next != added.end() && next->first <= it->second + 1) {
+            it->second = qMax(it->second, next->second);
+            added.erase(next);
+        }
+    } else {
+        added.insert(it, qMakePair(first, last));
+    }
+    if (sparse) {
+        auto it = std::lower_bound(exceptions.begin(), exceptions.end(), first);
+        for (; it != exceptions.end(); ++it) *it += count;
+    } else {
+        checked.insert(first, count);
+    }
+    rows += count;
+}
+
+void xTableView::BoolColumnMemory::removeRows(int first, int count) {
+    if (first >= rows) return;
+    count = qMin(count, rows - first);
+    const int last = first + count - 1;
+    const auto shift = [first, last, count](int row, int inside) {
+        return row < first ? row : (row > last ? row - count : inside);
+    };
+    auto it = runAtOrAfter(added, first);
+    for (auto run = it; run != added.end(); ++run) {
+        run->first = shift(run->first, first);
+        run->second = shift(run->second, first - 1);
+    }
+    added.erase(std::remove_if(it, added.end(),
+                               [](const QPair<int, int> &run) { return run.first > run.second; }),
+                added.end());
+    if (sparse) {
+        auto begin = std::lower_bound(exceptions.begin(), exceptions.end(), first);
+        auto end = std::lower_bound(begin, exceptions.end(), first + count);
+        for (auto it = end; it != exceptions.end(); ++it) *it -= count;
+        exceptions.erase(begin, end);
+    } else {
+        checked.remove(first, count);
+    }
+    rows -= count;
+}
+
+void xTableView::saveBoolColumnMemoryState(int column) {
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    if (!source) return;
+
+    // 按源模型行记，排序、过滤只改视图行号，不影响记住的值
+    BoolColumnMemory memory;
+    memory.rows = source->rowCount();
+    xTableBitmap checked(memory.rows);
+    for (int row = 0; row < memory.rows; ++row) {
+        const QVariant data = source->index(row, column).data(Qt::EditRole);
+        if (data.typeId() == QMetaType::Bool && data.toBool()) checked.setBit(row);
+    }
+
+    // 与多数值不同的行很少时（每行 4 字节不及位图的 1/8 字节）只记这些行
+    const int trues = checked.count();
+    memory.common = trues * 2 > memory.rows;
+    const int differing = memory.common ? memory.rows - trues : trues;
+    if (differing < memory.rows / 32) {
+        memory.sparse = true;
+        memory.exceptions.reserve(differing);
+        for (int row = 0; row < memory.rows; ++row) {
+            if (checked.testBit(row) != memory.common) memory.exceptions.append(row);
         }
+    } else {
+        memory.checked = std::move(checked);
     }
+    bool_column_memory_states_[column] = std::move(memory);
+}
+
+void xTableView::restoreBoolColumnMemoryState(int column) {
+    QAbstractItemModel *source = proxy_ ? proxy_->sourceModel() : model();
+    if (!source) return;
+
+    auto it = bool_column_memory_states_.constFind(column);
+    if (it == bool_column_memory_states_.constEnd()) {
+        return;  // No memory state saved
+    }
+
+    // 只改与记住的值不同的行；保存之后新插入的行不动
+    const BoolColumnMemory &memory = it.value();
+    const int rows = qMin(memory.rows, source->rowCount());
+    QVector<int> trueRows;
+    QVector<int> falseRows;
+    for (int row = 0; row < rows; ++row) {
+        if (!memory.known(row)) continue;
+        const QVariant data = source->index(row, column).data(Qt::EditRole);
+        if (data.typeId() != QMetaType::Bool) continue;
+        const bool remembered = memory.value(row);
+        if (data.toBool() != remembered) (remembered ? trueRows : falseRows).append(row);
+    }
+
+    auto *table = qobject_cast<xAbstractTableModel *>(source);
+    if (table) table->beginBatch();
+    setSourceColumnRows(column, trueRows, true);
+    setSourceColumnRows(column, falseRows, false);
+    if (table) table->endBatch();
 }
@@ -19,17 +19,21 @@
 #include <QMimeData>
 #include <QTextStream>
 #include <QRegularExpression>
+#include <QStringMatcher>
 #include <QAbstractTableModel>
 #include <QtWidgets>
 #include <QFont>
 #include <QSet>
 #include <QMap>
+#include <QHash>
 #include <QVector>
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QJsonObject>
 #include <optional>
+#include <memory>
 #include <zce/zce_any.h>
+#include "xTableCache.h"
 
 class QAbstractItemModel;
 
@@ -41,6 +45,17 @@ class xCheckableHeaderView;
 
 class xTableView;
 
+class xAbstractTableModel;
+
+class xTableSearchIndex;
+class xTableClipboardCopy;
+
+class QThreadPool;
+
+struct xTableViewFilterJob;
+
+struct xTableViewSortJob;
+
 struct xTableViewFilterRule {
     int column = -1;           // which column; -1 == global (not used yet)
     QRegularExpression regex;  // regex match (string values)
@@ -51,6 +66,26 @@ struct xTableViewFilterRule {
     bool active() const {
         return regex.isValid() && !regex.pattern().isEmpty() || equals.isValid() || hasBounds();
     }
+    xTableCellValue equals_value;  // `equals` decoded once, compared against column caches
+    // regex compiled into the cheapest predicate that gives the same answer; const after
+    // compile(), so one rule can be shared by every row and worker thread
+    enum MatchKind : quint8 {
+        MatchNone,
+        MatchLiteral,
+        MatchPrefix,
+        MatchSuffix,
+        MatchExact,
+        MatchRegex
+    };
+    MatchKind match_kind = MatchNone;
+    QString match_text;      // unescaped pattern body for the literal kinds
+    QStringMatcher matcher;  // case-insensitive substring search for MatchLiteral
+    void compile();
+    bool matchesText(const QString &text) const;
+    bool accepts(const QVariant &data) const;
+    bool accepts(const xTableColumnCache &cache, int row) const;
+    // true when every value this rule accepts is also accepted by previous
+    bool narrows(const xTableViewFilterRule &previous) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -58,19 +93,183 @@ struct xTableViewFilterRule {
 class xTableViewSortFilter : public QSortFilterProxyModel {
     Q_OBJECT
     QVector<xTableViewFilterRule> filters_;
+    bool column_cache_enabled_ = false;
+    QHash<int, xTableColumnCache> column_caches_;  // source column -> decoded values
+    QList<QMetaObject::Connection> source_connections_;
+    bool parallel_filter_enabled_ = false;
+    int parallel_filter_min_rows_ = 100000;
+    QThreadPool *filter_pool_ = nullptr;
+    std::shared_ptr<xTableViewFilterJob> filter_job_;
+    xTableBitmap accepted_rows_;  // source row -> accepted, read by filterAcceptsRow when valid
+    bool accepted_rows_valid_ = false;
+    bool rule_bitmaps_enabled_ = false;
+    QHash<int, xTableBitmap> rule_bitmaps_;  // filter column -> rows accepted by its rule
+    QHash<int, xTableColumnIndex> column_indexes_;  // source column -> sorted value index
+    const xAbstractTableModel *table_source_ = nullptr;  // sourceModel() when it is ours
+    struct CategoryPasses {
+        int generation = -1;     // xTableCategoryColumn::generation() the results belong to
+        QVector<quint8> passes;  // rule result per category code, last entry for empty cells
+    };
+    // filter column -> its rule's results, see categoryPasses()
+    mutable QHash<int, CategoryPasses> category_passes_;
+    QVector<QPair<int, Qt::SortOrder>> sort_columns_;  // most significant first
+    QVector<xTableSortKeys> sort_keys_;                 // one per entry of sort_columns_
+    QVector<int> sort_ranks_;  // source row -> rank of its key, empty once rows change
+    bool async_sort_enabled_ = false;
+    int async_sort_min_rows_ = 100000;
+    std::shared_ptr<xTableViewSortJob> sort_job_;
 
   public:
     explicit xTableViewSortFilter(QObject *parent = nullptr);
 
+    ~xTableViewSortFilter() override;
+
+    void setSourceModel(QAbstractItemModel *model) override;
+
     // add / replace filter for column
     void setColumnFilter(int column, const QVariantMap &conditions);
 
     void clearFilters();
 
+    // opt-in: keep decoded values of filtered columns, so filtering skips data()/QVariant
+    void setColumnCacheEnabled(bool enabled);
+
+    bool columnCacheEnabled() const { return column_cache_enabled_; }
+
+    // test tables of at least minRows rows on worker threads, then apply the result at once
+    void setParallelFilterEnabled(bool enabled, int minRows = 100000);
+
+    bool parallelFilterEnabled() const { return parallel_filter_enabled_; }
+
+    bool isFiltering() const { return filter_job_ != nullptr; }
+
+    // drop the in-flight parallel pass; a newer filter change does this automatically
+    void cancelFilter();
+
+    // keep one match bitmap per filtered column and AND them into the accept set, so
+    // changing one column's filter only re-tests that column (takes precedence over the
+    // parallel pass)
+    void setRuleBitmapsEnabled(bool enabled);
+
+    bool ruleBitmapsEnabled() const { return rule_bitmaps_enabled_; }
+
+    // keep a sorted value -> rows index of column, so min/max and equals rules on it are
+    // resolved by binary search and only the candidate rows are tested
+    void setColumnIndexed(int column, bool indexed);
+
+    bool isColumnIndexed(int column) const { return column_indexes_.contains(column); }
+
+    // extracts the column's sort keys once, so lessThan compares ranks instead of data()
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // sort by several columns, most significant first; sortColumn() / sortOrder() report the
+    // first one. Numeric and bool key columns are ordered with a radix sort.
+    void sortByColumns(const QVector<QPair<int, Qt::SortOrder>> &columns);
+
+    QVector<QPair<int, Qt::SortOrder>> sortColumns() const { return sort_columns_; }
+
+    // sort tables of at least minRows rows on a worker thread: only the raw values of the sort
+    // columns are copied here, keys and order are built on the worker. sort() returns at once
+    // and the order is installed in one layout change; rows inserted, removed or edited
+    // meanwhile are merged into it instead of starting over
+    void setAsyncSortEnabled(bool enabled, int minRows = 100000);
+
+    bool asyncSortEnabled() const { return async_sort_enabled_; }
+
+    bool isSorting() const { return sort_job_ != nullptr; }
+
+    // drop the in-flight background sort; a newer sort() does this automatically
+    void cancelSort();
+
+  signals:
+    void filterProgress(int processedRows, int totalRows);
+
+    void filterFinished();
+
+    void sortStarted(int column, Qt::SortOrder order);
+
+    // applied is false when the sort was cancelled
+    void sortFinished(bool applied);
+
   protected:
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
 
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+  private:
+    bool useColumnCache() const { return column_cache_enabled_ || parallel_filter_enabled_; }
+
+    const xTableColumnCache *cachedColumn(int column, int sourceRow) const;
+
+    // categorical storage of column when sourceRow is in it, nullptr otherwise
+    const xTableCategoryColumn *categoryColumn(int column, int sourceRow = 0) const;
+
+    // fr's result for every category code of its column, last entry for empty cells
+    const QVector<quint8> &categoryPasses(const xTableViewFilterRule &fr,
+                                          const xTableCategoryColumn &categories) const;
+
+    // every rule is on a categorical column, so a serial pass only reads codes
+    bool categoryRulesOnly() const;
+
+    bool testRow(int sourceRow, const QModelIndex &sourceParent) const;
+
+    bool testRule(const xTableViewFilterRule &fr, int sourceRow,
+                  const QModelIndex &sourceParent = QModelIndex()) const;
+
+    void updateRuleBitmap(int column, bool narrowed);
+
+    void combineRuleBitmaps();
+
+    void rebuildColumnCaches(const QAbstractItemModel *model);
+
+    void rebuildColumnIndexes(const QAbstractItemModel *model);
+
+    // superset of the rows fr accepts, looked up in its column index; false when fr has no
+    // usable index (rows == nullptr only asks)
+    bool indexedRuleRows(const xTableViewFilterRule &fr, xTableBitmap *rows) const;
+
+    // indexedRuleRows of every indexed rule ANDed together
+    bool indexedCandidates(xTableBitmap *rows) const;
+
+    // narrowed: the new rules can only reject rows the old ones accepted
+    void applyFilterChange(bool narrowed = false);
+
+    void rebuildAcceptedRows();
+
+    void narrowAcceptedRows();
+
+    void retestRows(int first, int last);
+
+    void invalidateRowFilter();
+
+    void startParallelFilter();
+
+    void onFilterChunkFinished(const std::shared_ptr<xTableViewFilterJob> &job, int finished);
+
+    void onSourceStructureChanged();
+
+    void rebuildSortKeys();
+
+    bool sortKeysUsable(const QModelIndex &left, const QModelIndex &right) const;
+
+    bool sortKeysLessThan(int left, int right) const;
+
+    void startAsyncSort();
+
+    void onSortJobFinished(const std::shared_ptr<xTableViewSortJob> &job);
+
+    // merge rows inserted, removed or edited while job ran into its order, setting sort_keys_
+    // and sort_ranks_; false when the changes do not line up with the model
+    bool patchSortRanks(const xTableViewSortJob &job);
+
+    bool isPlaceholderRow(int sourceRow) const;
+
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QList<int> &roles);
+
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -105,6 +304,19 @@ class xAbstractTableModel : public QAbstractTableModel {
 
     int hint_column_ = 0;
 
+  private:
+    int batch_depth_ = 0;
+    QVector<quint64> batch_cells_;  // (row << 32) | column of single cells touched in the batch
+    QVector<QRect> batch_ranges_;   // larger rectangles, x = column, y = row
+    QSet<int> batch_roles_;
+    bool batch_all_roles_ = false;
+    quint64 batch_records_ = 0;       // changes recorded into batches so far
+    quint64 data_changed_emits_ = 0;  // dataChanged signals emitted so far
+    int missing_rows_ = 0;            // rows appendRows announced but the subclass refused
+    int key_column_ = -1;
+    QHash<QString, int> key_rows_;  // key (string form) -> base row
+    QVector<QString> row_keys_;     // base row -> key, to repair key_rows_ on changes
+
   public:
     explicit xAbstractTableModel(QObject *parent = nullptr);
 
@@ -124,6 +336,57 @@ class xAbstractTableModel : public QAbstractTableModel {
 
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
 
+    // Cell updates made through setData / notifyDataChanged between beginBatch() and the
+    // matching endBatch() are held back, then emitted as a few merged dataChanged
+    // rectangles (roles merged too) when the outermost batch ends. Batches nest.
+    // A subclass that emits dataChanged itself instead of calling notifyDataChanged is not
+    // held back; its other signals (rows, columns, headers) always go out as usual.
+    void beginBatch();
+
+    void endBatch();
+
+    bool inBatch() const { return batch_depth_ > 0; }
+
+    // emit dataChanged now, or record it for the running batch
+    void notifyDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                           const QList<int> &roles = QList<int>());
+
+    // append rows after the real data (before the placeholder row) with one rowsInserted;
+    // rows[i] then fills the new row's columns in order through baseSetData inside one batch.
+    // If the subclass refuses a row, the rows it did not build are removed again at once.
+    bool appendRows(const QVector<QVariantList> &rows);
+
+    // assign value to column in each of rows (base rows, any order) as one batch, so views
+    // see a single merged dataChanged; read-only cells are skipped. Models with columnar
+    // storage can override it to write the column directly.
+    virtual bool setColumnData(int column, const QVector<int> &rows, const QVariant &value,
+                               int role = Qt::EditRole);
+
+    // update the row whose keyColumn holds values[keyColumn], or append it when there is none
+    bool upsertRow(int keyColumn, const QVariantList &values);
+
+    // Index base rows by the value of column, compared by its string form, so rowForKey()
+    // and upsert() are O(1). Kept current through inserts, removals, edits and append mode.
+    // Keys should be unique; with duplicates the last written row wins. -1 drops the index.
+    void setKeyColumn(int column);
+
+    int keyColumn() const { return key_column_; }
+
+    // base row holding key, -1 when absent or no key column is set
+    int rowForKey(const QVariant &key) const;
+
+    // update the row holding key in place or append a new one; values are in column order,
+    // the key column entry is filled from key
+    bool upsert(const QVariant &key, const QVariantList &values);
+
+    // Dictionary-encoded storage of column when it is categorical (its Display/Edit value is
+    // the category text), nullptr otherwise. xTableViewSortFilter then evaluates filter
+    // rules once per category and sorts by category rank.
+    virtual const xTableCategoryColumn *categoryColumn(int column) const {
+        Q_UNUSED(column);
+        return nullptr;
+    }
+
   protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
@@ -141,6 +404,28 @@ class xAbstractTableModel : public QAbstractTableModel {
     // this function is called by the model when a new row is inserted.
     // begin/endInsertRows managed by the model, so you don't need to call them here.
     virtual bool insertNewBaseRow(int row, const QVariant &value) = 0;
+
+  private:
+    // baseSetData; inside a batch the cell is recorded unless the subclass reported it
+    bool batchedBaseSetData(const QModelIndex &index, const QVariant &value, int role);
+
+    void recordBatchChange(int top, int left, int bottom, int right, const QList<int> &roles);
+
+    // keep pending batch rows aligned with rows inserted (count > 0) or removed (count < 0)
+    void shiftBatchRows(int first, int count);
+
+    void flushBatch();
+
+    QString keyAt(int row) const;
+
+    void rebuildKeyIndex();
+
+    // re-read the keys of base rows first..last
+    void updateRowKeys(int first, int last);
+
+    void onKeyRowsInserted(int first, int last);
+
+    void onKeyRowsRemoved(int first, int last);
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -155,6 +440,7 @@ class xTableView : public QTableView {
     static constexpr int BoolColumnStateRole = Qt::UserRole + 106;
     static constexpr int StringMapRole = Qt::UserRole + 107;
     static constexpr int StringMapDialogFactoryRole = Qt::UserRole + 108;
+    static constexpr int LoadingRole = Qt::UserRole + 109;  // true while the cell is being fetched
     enum NUMBER_DISPLAY_MODE { MODE_GENERAL, MODE_FIXFLOAT, MODE_SCIENTIFIC };
 
   private:  // data members
@@ -168,11 +454,55 @@ class xTableView : public QTableView {
     int freeze_rows_ = 0;
     int current_sort_col_ = -1;  //  -1 if no column is sorted
     Qt::SortOrder current_sort_order_ = Qt::AscendingOrder;
+    QVector<QPair<int, Qt::SortOrder>> sort_columns_;  // shift-click sort stack, primary first
     bool is_stretch_to_fill_ = false;
     QList<int> column_width_ratios_;
     QSet<int> bool_columns_;
-    QMap<int, QVector<bool>> bool_column_memory_states_;
+    // remembered values of a bool column, kept by source row so that sorting or filtering
+    // does not move them: a bitmap, or only the rows that differ when there are few of them
+    struct BoolColumnMemory {
+        int rows = 0;
+        bool sparse = false;
+        bool common = false;      // sparse: value of every row not listed
+        QVector<int> exceptions;  // sparse: ascending rows holding !common
+        xTableBitmap checked;     // dense
+        // ascending, disjoint [first, last] runs of rows inserted after the save; shifted in
+        // place like exceptions, so inserts cost O(runs), not O(rows)
+        QVector<QPair<int, int>> added;
+
+        // row was saved, not inserted since
+        bool known(int row) const;
+
+        bool value(int row) const;
+
+        void insertRows(int first, int count);
+
+        void removeRows(int first, int count);
+    };
+    QMap<int, BoolColumnMemory> bool_column_memory_states_;
+    // per bool column: which source rows hold a bool / a true bool / are visible in the view,
+    // and the totals over the visible ones, kept current from the models' signals so the header
+    // state is O(1) per update and a re-sort costs nothing
+    struct BoolColumnCounter {
+        xTableBitmap valid;
+        xTableBitmap checked;
+        xTableBitmap counted;
+        int counted_rows = 0;  // -1 until the visible rows are counted again
+        int valid_count = 0;
+        int checked_count = 0;
+    };
+    QHash<int, BoolColumnCounter> bool_column_counters_;
+    QList<QMetaObject::Connection> bool_counter_connections_;
     xCheckableHeaderView *checkable_header_;
+    xTableSearchIndex *search_index_ = nullptr;  // over the source model, made by findText
+    QPointer<xTableClipboardCopy> clipboard_copy_;  // running background copy, if any
+    QString search_text_;
+    bool highlight_all_ = false;
+    QList<QMetaObject::Connection> search_connections_;
+    // cells of model() matching search_text_ as sorted (row, column), rebuilt lazily
+    mutable QVector<QPair<int, int>> search_hits_;
+    mutable bool search_hits_valid_ = false;
+    mutable quint64 search_version_ = 0;
 
   public:
     static QString anyToString(const zce::Any &a);
@@ -185,6 +515,19 @@ class xTableView : public QTableView {
     
     zce::Any getItemAny(int row, int col) const;
 
+    // Write a block of the source model starting at (row, col); an xAbstractTableModel gets it
+    // as one batched update with a single dataChanged, other models see one setData per cell
+    // and emit their own signals. matrix is a vector of rows (each a vector of cells) or a dict of
+    // column title -> vector of cells; dict keys are matched against the header titles (col
+    // is not used) and missing titles become new columns when the model can insert them.
+    // Rows and columns past the end are added where the model allows. Cells of an
+    // xAbstractTableModel are stored as native values, other models get zce::Any like
+    // setItemAny. Returns false when a dict column could not be added and was dropped.
+    bool setRangeAny(int row, int col, const zce::Any &matrix);
+
+    // cells of the source model block as a vector of rows, built without anyToString
+    zce::Any getRangeAny(int row, int col, int rows, int cols) const;
+
     // Set the table view to stretch to fill the parent widget
     void setStretchToFill(bool enabled);
 
@@ -213,6 +556,30 @@ class xTableView : public QTableView {
 
     void sortBy(int col, Qt::SortOrder ord = Qt::AscendingOrder);
 
+    // multi-column sort, most significant column first (what shift-clicking headers builds)
+    void sortByColumns(const QVector<QPair<int, Qt::SortOrder>> &columns);
+
+    QVector<QPair<int, Qt::SortOrder>> sortColumns() const { return sort_columns_; }
+
+    // Find API (Ctrl+F emits findRequested, F3 / Shift+F3 step through matches) ---------
+
+    // case-insensitive search of every column's display text through a trigram index;
+    // moves to the first match at or after the current cell, returns the visible match count
+    int findText(const QString &text);
+
+    QString searchText() const { return search_text_; }
+
+    bool findNext();
+
+    bool findPrevious();
+
+    void setHighlightAll(bool enabled);
+
+    bool highlightAll() const { return highlight_all_; }
+
+    // index of model(); true when highlight-all is on and the cell matches the search text
+    bool isSearchHighlighted(const QModelIndex &index) const;
+
     // Freeze API -------------------------------------------------------------------------
 
     void freezeLeftColumns(int n);
@@ -266,6 +633,7 @@ class xTableView : public QTableView {
 
   private:
     // Copy / Paste / Delete --------------------------------------------------------------
+    // TSV, CSV and HTML in one QMimeData; large selections are copied in the background
     void copySelection();
 
     void paste();
@@ -294,8 +662,38 @@ class xTableView : public QTableView {
 
     void restoreBoolColumnMemoryState(int column);
 
+    // track source (and the proxy over it); call before the proxy connects to source
+    void connectBoolColumnCounters(QAbstractItemModel *source);
+
+    // write value into column for every visible row as one model transaction
+    void setColumnRows(int column, const QVariant &value);
+
+    // write value into column at the given source-model rows; an xAbstractTableModel takes
+    // them as one transaction, other models get one setData per row
+    void setSourceColumnRows(int column, const QVector<int> &sourceRows, const QVariant &value);
+
+    void rebuildBoolColumnCounter(int column);
+
+    // re-derive which source rows are visible and their totals from the bits, no data() reads
+    void recountBoolColumn(int column);
+
+    // re-read source rows first..last of column into its counter
+    void countBoolRows(int column, int first, int last);
+
+    int boolSourceRow(int row) const;
+
     // Edit state preservation helpers
     void restoreEditorContent(QWidget *editor);
+
+    // Find helpers
+    void ensureSearchHits() const;
+
+    // re-test only the edited cells against search_text_
+    void onSearchCellsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+    bool stepSearch(bool forward, bool inclusive);
+
+    void connectSearchInvalidation();
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////